@@ -1,5 +1,9 @@
 #include "appcontroller.h"
 #include "vertexholderdrawer.h"
+#include "sceneio.h"
+#include "modelio.h"
+
+#include <QDebug>
 
 
 // ==================================================================================================
@@ -8,7 +12,9 @@
 AppController::AppController(MainWindow* window) {
     this->window = window;
     mouseFollower = new MouseFollower(window->Canvas());
+    mouseFollower->SetIndex(&vertexIndex);
     hintBox = nullptr;
+    scene = new Scene();
 
     beginDrawing();
     subscribeMouseActions();
@@ -18,12 +24,46 @@ AppController::AppController(MainWindow* window) {
     connect(window, &MainWindow::editPressed, this, &AppController::onEditPressed);
     connect(window, &MainWindow::lightingValueChanged, this, &AppController::onLightingValueChanged);
     connect(window, &MainWindow::cameraRotationChanged, this, &AppController::onCameraRotationChanged);
+    connect(window, &MainWindow::cameraClippingChanged, this, &AppController::onCameraClippingChanged);
+    connect(window, &MainWindow::cameraLimitsChanged, this, &AppController::onCameraLimitsChanged);
+    connect(window, &MainWindow::cameraFovChanged, this, &AppController::onCameraFovChanged);
+    connect(window, &MainWindow::cameraPerspectiveChanged, this, &AppController::onCameraPerspectiveChanged);
     connect(window, &MainWindow::shadingChanged, this, &AppController::onShadingChanged);
+    connect(window, &MainWindow::antiAliasingChanged, this, &AppController::onAntiAliasingChanged);
+    connect(window, &MainWindow::visibilityChanged, this, &AppController::onVisibilityChanged);
+    connect(window, &MainWindow::textureChanged, this, &AppController::onTextureChanged);
+    connect(window, &MainWindow::lodToleranceChanged, this, &AppController::onLodToleranceChanged);
+    connect(window, &MainWindow::heatmapChanged, this, &AppController::onHeatmapChanged);
+    connect(window, &MainWindow::shadowsChanged, this, &AppController::onShadowsChanged);
 }
 
 // ==================================================================================================
 AppController::~AppController() {
     clearAllData();
+    delete scene;
+    delete texture;
+}
+
+// ==================================================================================================
+bool AppController::LoadScene(const QString& path) {
+    QString error;
+    if (ModelIO::IsModel(path)) {
+        std::unique_ptr<Model> model(new Model);
+        if (!ModelIO::Load(path, *model, &error)) {
+            qWarning() << "could not load model" << path << ":" << error;
+            return false;
+        }
+        model->FitTo(window->Canvas()->width(), window->Canvas()->height());
+        scene->Clear();
+        scene->AddModel(std::move(model));
+    }
+    else if (!SceneIO::Load(path, *scene, &error)) {
+        qWarning() << "could not load scene" << path << ":" << error;
+        return false;
+    }
+
+    window->Canvas()->Invalidate(Drawer::SCENE);
+    return true;
 }
 
 // ==================================================================================================
@@ -34,15 +74,28 @@ QPoint* AppController::createNewPoint(QPoint pos) {
     polygonDrawer->Vertices.push_back(point);
 
     auto vertex = new VertexHolderDrawer(window->Canvas(), point);
+    vertexIndex.Insert(point, static_cast<int>(holders.size()));
     holders.push_back(vertex);
     vertices.push_back(point);
     window->Canvas()->AddDrawer(vertex);
+    window->Canvas()->Invalidate(Drawer::SCENE);
 
     return point;
 }
 
+// ==================================================================================================
+void AppController::setHighlighted(int index) {
+    if (index == highlighted) { return; }
+
+    if (highlighted >= 0) { holders[static_cast<size_t>(highlighted)]->setIsSelected(false); }
+    if (index >= 0) { holders[static_cast<size_t>(index)]->setIsSelected(true); }
+    highlighted = index;
+}
+
 // ==================================================================================================
 void AppController::clearAllData() {
+    vertexIndex.Clear();
+    highlighted = -1;
     for (auto v : vertices)
         delete v;
     vertices.clear();
@@ -56,7 +109,9 @@ void AppController::clearAllData() {
     }
 
     delete lighting;
+    lighting = nullptr;
     delete camera;
+    camera = nullptr;
 }
 
 // ==================================================================================================
@@ -107,20 +162,108 @@ void AppController::onShadingChanged(const QString & shading) {
     polygonDrawer->SetShading(this->shading);
 }
 
+void AppController::onAntiAliasingChanged(bool antiAliasing) {
+    this->antiAliasing = antiAliasing;
+    polygonDrawer->SetAntiAliasing(antiAliasing);
+}
+
+void AppController::onVisibilityChanged(const QString& visibility) {
+    if (visibility == "Scanline")
+        this->visibility = PolygonDrawer::Visibility::SCANLINE;
+    else if (visibility == "S-buffer")
+        this->visibility = PolygonDrawer::Visibility::SBUFFER;
+    else
+        this->visibility = PolygonDrawer::Visibility::ZBUFFER;
+
+    polygonDrawer->SetVisibility(this->visibility);
+}
+
+void AppController::onTextureChanged(const QString& path) {
+    QImage image(path);
+    if (image.isNull()) {
+        qWarning() << "could not load texture" << path;
+        return;
+    }
+
+    auto previous = texture;
+    texture = new Texture(image);
+    polygonDrawer->SetTexture(texture);
+    delete previous;
+}
+
+// ==================================================================================================
+void AppController::onLodToleranceChanged(double pixels) {
+    lodTolerance = static_cast<float>(pixels);
+    polygonDrawer->SetLodTolerance(lodTolerance);
+}
+
+// ==================================================================================================
+void AppController::onHeatmapChanged(const QString& heatmap) {
+    if (heatmap == "Z tests")
+        this->heatmap = PolygonDrawer::Heatmap::DEPTH_TESTS;
+    else if (heatmap == "Overdraw")
+        this->heatmap = PolygonDrawer::Heatmap::WRITES;
+    else if (heatmap == "Lighting")
+        this->heatmap = PolygonDrawer::Heatmap::SHADING_COST;
+    else
+        this->heatmap = PolygonDrawer::Heatmap::NONE;
+
+    polygonDrawer->SetHeatmap(this->heatmap);
+}
+
+// ==================================================================================================
+void AppController::onShadowsChanged(bool shadows) {
+    this->shadows = shadows;
+    polygonDrawer->SetShadows(shadows);
+}
+
 // ==================================================================================================
 void AppController::onLightingValueChanged(int x, int y, int z) {
     light.setX(x);
     light.setY(y);
     light.setZ(z);
+    if (lighting != nullptr) { lighting->SetVector(0, light); }
 
-    window->Canvas()->update();
+    window->Canvas()->Invalidate(Drawer::SCENE);
 }
 
 void AppController::onCameraRotationChanged(int x, int y, int z) {
     QVector3D rot(x, y, z);
-    camera->SetRotation(rot);
+    if (camera != nullptr) { camera->SetRotation(rot); }
+
+    window->Canvas()->Invalidate(Drawer::SCENE);
+}
+
+void AppController::onCameraClippingChanged(int nearZ, int farZ) {
+    if (camera == nullptr) { return; }
+    camera->nearZ = nearZ;
+    camera->farZ = farZ;
+
+    window->Canvas()->Invalidate(Drawer::SCENE);
+}
+
+void AppController::onCameraLimitsChanged(int hMin, int hMax, int vMin, int vMax) {
+    if (camera == nullptr) { return; }
+    camera->hMin = hMin;
+    camera->hMax = hMax;
+    camera->vMin = vMin;
+    camera->vMax = vMax;
+
+    window->Canvas()->Invalidate(Drawer::SCENE);
+}
+
+void AppController::onCameraFovChanged(double fovY) {
+    if (camera == nullptr) { return; }
+    camera->fovY = fovY;
 
-    window->Canvas()->update();
+    window->Canvas()->Invalidate(Drawer::SCENE);
+}
+
+void AppController::onCameraPerspectiveChanged(bool perspective) {
+    if (camera == nullptr) { return; }
+    camera->isPerspective = perspective;
+
+    window->Canvas()->Invalidate(Drawer::SCENE);
 }
 
 // ==================================================================================================
@@ -146,33 +289,20 @@ void AppController::subscribeMouseActions() {
     window->Canvas()->OnMouseMoved.push_back([this](QMouseEvent* e) {
         if (state != eAppState::WAITING) { return; }
 
-        size_t closest = 0;
-        float minDist = 100000000;
-
-        for (size_t i = 0; i < vertices.size(); i++) {
-            auto dist = QVector2D(*vertices[i] - e->pos()).lengthSquared();
-            if (dist < minDist) {
-                closest = i;
-                minDist = dist;
-            }
-        }
-
-        if (minDist > 500) { closest = 0; }
-
-        for (size_t i = 0; i < holders.size(); i++)
-            holders[i]->setIsSelected(i == closest);
+        // nothing in range falls back to the first vertex, as the linear scan did
+        auto closest = vertexIndex.Nearest(e->pos(), 500);
+        setHighlighted(closest >= 0 || holders.empty() ? closest : 0);
     });
 
     // SETUP WAITING TRANSITION
     window->Canvas()->OnMousePressed.push_back([this](QMouseEvent* e) {
        if (state != eAppState::WAITING) { return; }
 
-       for (auto h : holders)
-           if (h->IsSelected()) {
-               mouseFollower->AddPoint(h->Vertex());
-               endWaiting();
-               beginEditing();
-           }
+       if (highlighted >= 0) {
+           mouseFollower->AddPoint(holders[static_cast<size_t>(highlighted)]->Vertex());
+           endWaiting();
+           beginEditing();
+       }
 
        (void) e;
     });
@@ -196,15 +326,17 @@ void AppController::subscribeMouseActions() {
             QVector3D rot(- 1.5f*dy, - 1.5f*dx, 0);
             camera->Rotate(rot);
 
+            // coarser outlines while rotating, like the flat shading
             polygonDrawer->SetShading(PolygonDrawer::Shading::FLAT);
+            polygonDrawer->SetLodTolerance(std::max(lodTolerance, 2.0f));
+            window->Canvas()->Invalidate(Drawer::SCENE);
         }
         else {
             polygonDrawer->SetShading(this->shading);
+            polygonDrawer->SetLodTolerance(lodTolerance);
         }
 
         this->mousePos = e->pos();
-
-        window->Canvas()->update();
     });
 }
 // ==================================================================================================
@@ -216,10 +348,18 @@ void AppController::beginDrawing() {
 
     camera = new Camera(QVector3D(0, 0, 0), QVector3D(0, 0, 0));
     light.setZ(1);
-    lighting = new LightSource(LightSource::Type::POINT, &light, 1.0);
+    lighting = new LightSet();
+    lighting->Add(LightSource::Type::POINT, light);
 
     shading = PolygonDrawer::Shading::FLAT;
     polygonDrawer = new PolygonDrawer(window->Canvas(), lighting, camera);
+    polygonDrawer->SetScene(scene);
+    polygonDrawer->SetAntiAliasing(antiAliasing);
+    polygonDrawer->SetVisibility(visibility);
+    polygonDrawer->SetTexture(texture);
+    polygonDrawer->SetLodTolerance(lodTolerance);
+    polygonDrawer->SetHeatmap(heatmap);
+    polygonDrawer->SetShadows(shadows);
     window->Canvas()->AddDrawer(polygonDrawer);
 
     auto point = createNewPoint(QPoint(-10, -10));
@@ -240,6 +380,7 @@ void AppController::beginVisualizing() {
     hintBox->Dismiss();
     for (auto h : holders)
         h->IsHidden = true;
+    window->Canvas()->Invalidate(Drawer::HANDLES);
 }
 
 void AppController::endDrawing() {
@@ -250,10 +391,8 @@ void AppController::endWaiting() {
 }
 
 void AppController::endEditing() {
-    for (auto h : holders)
-       if (h->IsSelected()) {
-           mouseFollower->RemovePoint(h->Vertex());
-       }
+    if (highlighted >= 0)
+        mouseFollower->RemovePoint(holders[static_cast<size_t>(highlighted)]->Vertex());
 }
 
 void AppController::endVisualizing() {
@@ -262,4 +401,5 @@ void AppController::endVisualizing() {
     hintBox->Show();
     for (auto h : holders)
         h->IsHidden = false;
+    window->Canvas()->Invalidate(Drawer::HANDLES);
 }
@@ -4,7 +4,7 @@
 #include "mainwindow.h"
 #include "vertexholderdrawer.h"
 
-#include "lightsource.h"
+#include "lightset.h"
 #include "camera.h"
 
 #include <QVector3D>
@@ -28,26 +28,41 @@ private:
 
     // EDIT MODE
     MouseFollower* mouseFollower;
+    VertexGrid vertexIndex;
+    int highlighted = -1;       // index of the selected holder, -1 when none
 
     // POLYGON DATA
     PolygonDrawer* polygonDrawer;
     std::vector<VertexHolderDrawer*> holders;
     std::vector<QPoint*> vertices;
 
+    // SCENE DATA (rendered together with the edited polygon)
+    Scene* scene;
+
     // LIGHTING DATA
     //std::vector<QPoint*> lights;
     QVector3D light;
-    LightSource* lighting;
+    LightSet* lighting;
     Camera* camera;
     QPoint mousePos;
     PolygonDrawer::Shading shading;
+    bool antiAliasing = false;
+    PolygonDrawer::Visibility visibility = PolygonDrawer::Visibility::ZBUFFER;
+    Texture* texture = nullptr;
+    float lodTolerance = 0.5f;
+    PolygonDrawer::Heatmap heatmap = PolygonDrawer::Heatmap::NONE;
+    bool shadows = false;
 
 public:
     AppController(MainWindow*);
     ~AppController();
 
+    // replaces the scene drawn around the edited polygon (binary .pslb or text file)
+    bool LoadScene(const QString& path);
+
 private:
     QPoint* createNewPoint(QPoint);
+    void setHighlighted(int);
     void clearAllData();
     void subscribeMouseActions();
 
@@ -66,9 +81,19 @@ private slots:
     void onClearPressed();
     void onEditPressed();
     void onShadingChanged(const QString&);
+    void onAntiAliasingChanged(bool);
+    void onVisibilityChanged(const QString&);
+    void onTextureChanged(const QString&);
+    void onLodToleranceChanged(double);
+    void onHeatmapChanged(const QString&);
+    void onShadowsChanged(bool);
 
     void onLightingValueChanged(int x, int y, int z);
     void onCameraRotationChanged(int x, int y, int z);
+    void onCameraClippingChanged(int nearZ, int farZ);
+    void onCameraLimitsChanged(int hMin, int hMax, int vMin, int vMax);
+    void onCameraFovChanged(double fovY);
+    void onCameraPerspectiveChanged(bool perspective);
 };
 
 #endif // APPCONTROLLER_H
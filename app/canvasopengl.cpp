@@ -16,20 +16,57 @@ CanvasOpenGL::~CanvasOpenGL() {
 // ==================================================================================================
 void CanvasOpenGL::SetPointsColor(QColor color) {
     pointsColor.setRgb(color.rgb());
-    this->update();
+    InvalidateAll();
 }
 
 // ==================================================================================================
 void CanvasOpenGL::AddDrawer(Drawer* drawer) {
     this->drawers.push_back(drawer);
+    Invalidate(drawer->GetLayer());
 }
 
 // ==================================================================================================
 void CanvasOpenGL::ClearScreen() {
     drawers.clear();
+    InvalidateAll();
+}
+
+// ==================================================================================================
+void CanvasOpenGL::Invalidate(Drawer::Layer layer) {
+    dirty[layer] = true;
+    this->update();
+}
+
+// ==================================================================================================
+void CanvasOpenGL::InvalidateAll() {
+    for (auto& d : dirty)
+        d = true;
     this->update();
 }
 
+// ==================================================================================================
+int CanvasOpenGL::RenderLayers() {
+    // only the dirty layers are drawn again, all drawers of a layer share one painter
+    int rendered = 0;
+    for (int l = 0; l < Drawer::LAYER_COUNT; l++) {
+        auto& image = layers[l];
+        if (image.size() != size()) {
+            image = QImage(size(), QImage::Format_ARGB32_Premultiplied);
+            dirty[l] = true;
+        }
+        if (!dirty[l]) { continue; }
+
+        image.fill(Qt::transparent);
+        QPainter painter(&image);
+        for (auto drawer : drawers)
+            if (drawer->GetLayer() == l)
+                drawer->Draw(painter, pointsColor);
+        dirty[l] = false;
+        rendered++;
+    }
+    return rendered;
+}
+
 // ==================================================================================================
 // PROTECTED MEMBERS
 // ==================================================================================================
@@ -37,8 +74,15 @@ void CanvasOpenGL::initializeGL() {}
 
 // ==================================================================================================
 void CanvasOpenGL::paintGL() {
-    for (auto drawer : drawers)
-        drawer->Draw(pointsColor);
+    RenderLayers();
+
+    // the scene replaces the previous frame, the overlays go over it
+    QPainter painter(this);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(0, 0, layers[Drawer::SCENE]);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    for (int l = Drawer::SCENE + 1; l < Drawer::LAYER_COUNT; l++)
+        painter.drawImage(0, 0, layers[l]);
 }
 
 // ==================================================================================================
@@ -46,16 +90,15 @@ void CanvasOpenGL::resizeGL(int w, int h) { }
 
 // ==================================================================================================
 void CanvasOpenGL::mousePressEvent(QMouseEvent *event) {
+    // the actions invalidate the layers they change
     for(auto action : OnMousePressed)
         action(event);
-    this->update();
 }
 
 // ==================================================================================================
 void CanvasOpenGL::mouseMoveEvent(QMouseEvent *event) {
     for(auto action : OnMouseMoved)
         action(event);
-    this->update();
 }
 
 // ==================================================================================================
@@ -67,5 +110,4 @@ void CanvasOpenGL::mouseDoubleClickEvent(QMouseEvent*) {
 void CanvasOpenGL::mouseReleaseEvent(QMouseEvent *event) {
     for(auto action : OnMouseReleased)
         action(event);
-    this->update();
 }
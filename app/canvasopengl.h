@@ -27,9 +27,19 @@ public:
     void AddDrawer(Drawer*);
     void ClearScreen();
 
+    // re-renders the layer on the next paint, the others are composited from their cache
+    void Invalidate(Drawer::Layer);
+    void InvalidateAll();
+
+    // redraws the dirty layers into their cache without painting the widget (paintGL does it
+    // first, session replay calls it directly), returns how many were redrawn
+    int RenderLayers();
+
 private:
     QColor pointsColor;
     vector<Drawer*> drawers;
+    QImage layers[Drawer::LAYER_COUNT];
+    bool dirty[Drawer::LAYER_COUNT] = {};
 
 
     // VIEWING MEMBERS
@@ -0,0 +1,14 @@
+#include "drawer.h"
+#include "canvasopengl.h"
+
+Drawer::Drawer(CanvasOpenGL* canvas, Layer layer) : canvas(canvas), layer(layer) { }
+
+Drawer::~Drawer() {}
+
+Drawer::Layer Drawer::GetLayer() const {
+    return layer;
+}
+
+void Drawer::invalidate() {
+    canvas->Invalidate(layer);
+}
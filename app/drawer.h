@@ -0,0 +1,38 @@
+#ifndef DRAWER_H
+#define DRAWER_H
+
+#include "qcolor.h"
+#include "qpoint.h"
+#include <QObject>
+
+class CanvasOpenGL;
+class QPainter;
+
+class Drawer : public QObject {
+public:
+    // the canvas caches every layer in its own image and composites them in this order
+    enum Layer {
+        SCENE,
+        HANDLES,
+        HINTS,
+        LAYER_COUNT
+    };
+
+protected:
+    CanvasOpenGL* canvas;
+    Layer layer;
+
+public:
+    Drawer(CanvasOpenGL* canvas, Layer layer = SCENE);
+    virtual ~Drawer();
+
+    // paints into the image of its layer, only called when the layer is dirty
+    virtual void Draw(QPainter& painter, QColor pointsColor) = 0;
+    Layer GetLayer() const;
+
+protected:
+    // marks the layer of the drawer for re-rendering
+    void invalidate();
+};
+
+#endif // DRAWER_H
@@ -6,7 +6,7 @@
 #define ANIM_DURATION 800
 
 // ==================================================================================================
-HintBoxDrawer::HintBoxDrawer(CanvasOpenGL* canvas) : Drawer(canvas) {
+HintBoxDrawer::HintBoxDrawer(CanvasOpenGL* canvas) : Drawer(canvas, HINTS) {
     animation = nullptr;
     Show();
 }
@@ -17,9 +17,7 @@ HintBoxDrawer::~HintBoxDrawer() {
 }
 
 // ==================================================================================================
-void HintBoxDrawer::Draw(QColor pointsColor) {
-    QPainter painter(canvas);
-
+void HintBoxDrawer::Draw(QPainter& painter, QColor pointsColor) {
     QBrush brush(pointsColor, Qt::SolidPattern);
     QPen pen(pointsColor);
 
@@ -40,8 +38,9 @@ QRect HintBoxDrawer::Rect() const {
 
 // ==================================================================================================
 void HintBoxDrawer::setRect(const QRect &rect) {
+    // an animation tick only redraws the hint layer
     this->rect = rect;
-    canvas->update();
+    invalidate();
 }
 
 // ==================================================================================================
@@ -23,7 +23,7 @@ public:
     HintBoxDrawer(CanvasOpenGL*);
     virtual ~HintBoxDrawer();
 
-    virtual void Draw(QColor pointsColor);
+    virtual void Draw(QPainter& painter, QColor pointsColor);
 
     // ACCESSORS
     QRect Rect() const;
@@ -9,9 +9,7 @@ LineDrawer::LineDrawer(CanvasOpenGL* canvas) : Drawer(canvas) { }
 LineDrawer::~LineDrawer() { }
 
 // ==================================================================================================
-void LineDrawer::Draw(QColor pointsColor) {
-    QPainter painter(canvas);
-
+void LineDrawer::Draw(QPainter& painter, QColor pointsColor) {
     QPen myPen(pointsColor, width);
     QBrush brush(pointsColor, Qt::SolidPattern);
 
@@ -12,7 +12,7 @@ public:
 public:
     LineDrawer(CanvasOpenGL*);
     virtual ~LineDrawer();
-    virtual void Draw(QColor pointsColor);
+    virtual void Draw(QPainter& painter, QColor pointsColor);
     void setWidth(const qreal);
 };
 
@@ -0,0 +1,59 @@
+#include "mainwindow.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <cstring>
+#include "appcontroller.h"
+#include "sessionrecorder.h"
+#include "sessionplayer.h"
+
+// ==================================================================================================
+int main(int argc, char *argv[]) {
+    // a replay needs no display, unless one was asked for
+    for (int i = 1; i < argc; i++)
+        if (std::strcmp(argv[i], "--replay") == 0 && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addPositionalArgument("scene", "Scene drawn around the edited polygon (.pslb or text), or an .obj or .ply mesh.", "[scene]");
+    parser.addOptions({
+        {"record", "Records the session to a file.", "file"},
+        {"replay", "Plays a recorded session headless and prints its frame times.", "file"},
+        {"realtime", "Plays the session at its recorded pace instead of as fast as possible."},
+        {"timings", "Writes the time of every replayed frame to a CSV file.", "file"},
+    });
+    parser.process(a);
+
+    MainWindow w;
+    AppController app(&w);
+    if (!parser.positionalArguments().isEmpty())
+        app.LoadScene(parser.positionalArguments().first());
+
+    if (parser.isSet("replay")) {
+        QString error;
+        SessionPlayer player(&w);
+        if (!player.Play(parser.value("replay"), parser.isSet("realtime"), &error)) {
+            qWarning() << "could not replay" << parser.value("replay") << ":" << error;
+            return 1;
+        }
+        qInfo().noquote() << player.Summary();
+        if (parser.isSet("timings") && !player.SaveTimings(parser.value("timings"), &error)) {
+            qWarning() << "could not write" << parser.value("timings") << ":" << error;
+            return 1;
+        }
+        return 0;
+    }
+
+    SessionRecorder recorder(&w);
+    if (parser.isSet("record")) {
+        QString error;
+        if (!recorder.Start(parser.value("record"), &error))
+            qWarning() << "could not record to" << parser.value("record") << ":" << error;
+    }
+
+    w.show();
+    return a.exec();
+}
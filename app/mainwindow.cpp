@@ -7,6 +7,7 @@
 #include "hintboxdrawer.h"
 
 #include <QColorDialog>
+#include <QFileDialog>
 
 
 // ==================================================================================================
@@ -59,7 +60,7 @@ void MainWindow::on_changeColor_released() {
     //QColorDialogTester color_test;
     //color_test.onColor();
 
-    QColor color = QColorDialog::getColor(this->color, this );
+    QColor color = QColorDialog::getColor(this->color, this, QString(), QColorDialog::ShowAlphaChannel);
     if( color.isValid() )
     {
         this->color = color;
@@ -67,6 +68,12 @@ void MainWindow::on_changeColor_released() {
     }
 }
 
+void MainWindow::on_changeTexture_released() {
+    auto path = QFileDialog::getOpenFileName(this, "Texture", QString(), "Images (*.png *.jpg *.jpeg *.bmp)");
+    if (!path.isEmpty())
+        emit textureChanged(path);
+}
+
 
 // ==================================================================================================
 void MainWindow::on_obsXValue_valueChanged(double x) {
@@ -112,6 +119,30 @@ void MainWindow::on_toningValue_currentTextChanged(const QString &shading) {
     emit shadingChanged(shading);
 }
 
+void MainWindow::on_antiAliasing_toggled(bool checked) {
+    emit antiAliasingChanged(checked);
+}
+
+void MainWindow::on_perspective_toggled(bool checked) {
+    emit cameraPerspectiveChanged(checked);
+}
+
+void MainWindow::on_visibilityValue_currentTextChanged(const QString &visibility) {
+    emit visibilityChanged(visibility);
+}
+
+void MainWindow::on_lodTolerance_valueChanged(double pixels) {
+    emit lodToleranceChanged(pixels);
+}
+
+void MainWindow::on_heatmapValue_currentTextChanged(const QString &heatmap) {
+    emit heatmapChanged(heatmap);
+}
+
+void MainWindow::on_shadows_toggled(bool checked) {
+    emit shadowsChanged(checked);
+}
+
 // ==================================================================================================
 void MainWindow::on_ResetButton_released() {
     onReset();
@@ -124,6 +155,8 @@ void MainWindow::onReset() {
     this->ui->obsYValue->setValue(0.0);
     this->ui->obsZValue->setValue(0.0);
     emit cameraRotationChanged(0, 0, 0);
+    this->ui->perspective->setChecked(true);
+    emit cameraPerspectiveChanged(true);
 
     // Lighting
     this->ui->lightValueX->setValue(openGlCanvas->width()/2);
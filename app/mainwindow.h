@@ -45,6 +45,12 @@ signals:
     void clearPressed();
     void editPressed();
     void shadingChanged(const QString&);
+    void antiAliasingChanged(bool);
+    void visibilityChanged(const QString&);
+    void textureChanged(const QString&);
+    void lodToleranceChanged(double);
+    void heatmapChanged(const QString&);
+    void shadowsChanged(bool);
 
     void lightingValueChanged(int, int, int);
     void cameraRotationChanged(int, int, int);
@@ -56,6 +62,7 @@ signals:
 private slots:
     void on_ClearButton_clicked();
     void on_changeColor_released();
+    void on_changeTexture_released();
 
     void on_obsXValue_valueChanged(double arg1);
     void on_obsYValue_valueChanged(double arg1);
@@ -64,6 +71,12 @@ private slots:
     void on_lightValueY_valueChanged(double arg1);
     void on_lightValueZ_valueChanged(double arg1);
     void on_toningValue_currentTextChanged(const QString &arg1);
+    void on_antiAliasing_toggled(bool checked);
+    void on_perspective_toggled(bool checked);
+    void on_visibilityValue_currentTextChanged(const QString &arg1);
+    void on_lodTolerance_valueChanged(double arg1);
+    void on_heatmapValue_currentTextChanged(const QString &arg1);
+    void on_shadows_toggled(bool checked);
     void on_ResetButton_released();
     void on_editButton_released();
 };
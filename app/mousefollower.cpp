@@ -0,0 +1,29 @@
+#include "mousefollower.h"
+#include <iostream>
+
+
+MouseFollower::MouseFollower(CanvasOpenGL* mouseCanvas) : canvas(mouseCanvas) {
+    mouseCanvas->OnMouseMoved.push_back([this](QMouseEvent* e) {
+       for(auto point : this->following) {
+           point->setX(e->x());
+           point->setY(e->y());
+           if (index != nullptr) { index->Update(point); }
+       }
+
+       // a moved vertex changes the polygon and its handle
+       if (!following.empty()) {
+           canvas->Invalidate(Drawer::SCENE);
+           canvas->Invalidate(Drawer::HANDLES);
+       }
+    });
+}
+
+void MouseFollower::AddPoint(QPoint* point) {
+    following.insert(point);
+}
+void MouseFollower::RemovePoint(QPoint* point) {
+    following.erase(point);
+}
+void MouseFollower::SetIndex(VertexGrid* index) {
+    this->index = index;
+}
@@ -3,17 +3,23 @@
 
 #include <qpoint.h>
 #include "canvasopengl.h"
+#include "vertexgrid.h"
 #include <unordered_set>
 
 class MouseFollower
 {
 private:
+    CanvasOpenGL* canvas;
     std::unordered_set<QPoint*> following;
+    VertexGrid* index = nullptr;
 
 public:
     MouseFollower(CanvasOpenGL*);
     void AddPoint(QPoint*);
     void RemovePoint(QPoint*);
+
+    // spatial index kept up to date with the points moved (not owned)
+    void SetIndex(VertexGrid*);
 };
 
 #endif // MOUSEFOLLOWER_H
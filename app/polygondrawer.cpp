@@ -0,0 +1,33 @@
+#include "polygondrawer.h"
+#include "canvasopengl.h"
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+PolygonDrawer::PolygonDrawer(CanvasOpenGL* canvas, LightSet* lights, Camera* camera) :
+    Drawer(canvas), PolygonRenderer(lights, camera) {}
+
+// ==================================================================================================
+void PolygonDrawer::Draw(QPainter& painter, QColor paintColor) {
+    frame.Resize(canvas->width(), canvas->height());
+    Render(frame, paintColor);
+
+    painter.drawImage(0, 0, frame.Image());
+
+    auto& stats = Stats();
+    painter.setPen(Qt::white);
+    if (GetHeatmap() != Heatmap::NONE) {
+        auto overdraw = stats.covered > 0 ? static_cast<double>(stats.writes) / stats.covered : 0.0;
+        painter.drawText(8, 16, QString("overdraw %1  z pass %2  z fail %3  shades %4")
+                         .arg(overdraw, 0, 'f', 2)
+                         .arg(stats.depthPassed)
+                         .arg(stats.depthFailed)
+                         .arg(stats.shades));
+    }
+    if (AllocTracker::Enabled()) {
+        painter.drawText(8, 32, QString("allocations %1  bytes %2  peak %3")
+                         .arg(stats.allocations)
+                         .arg(stats.allocatedBytes)
+                         .arg(stats.peakBytes));
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef POLYGONDRAWER_H
+#define POLYGONDRAWER_H
+
+#include "drawer.h"
+#include "polygonrenderer.h"
+
+// Puts the scanline engine on the canvas: renders into its own frame buffer at the size of the
+// canvas and repaints the scene layer whenever a setting changes.
+class PolygonDrawer : public Drawer, public PolygonRenderer
+{
+private:
+    FrameBuffer frame;
+
+public:
+    PolygonDrawer(CanvasOpenGL* canvas, LightSet* lights, Camera* camera);
+    void Draw(QPainter& painter, QColor pointsColor);
+
+protected:
+    void changed();
+};
+
+#endif // POLYGONDRAWER_H
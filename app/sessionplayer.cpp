@@ -0,0 +1,158 @@
+#include "sessionplayer.h"
+#include "sessionrecorder.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QCoreApplication>
+#include <algorithm>
+
+// ==================================================================================================
+static bool fail(QString* error, const QString& message) {
+    if (error != nullptr) { *error = message; }
+    return false;
+}
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+SessionPlayer::SessionPlayer(MainWindow* window) : window(window) {}
+
+// ==================================================================================================
+bool SessionPlayer::Play(const QString& path, bool realtime, QString* error) {
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+        return fail(error, file.errorString());
+
+    QTextStream in(&file);
+    auto header = in.readLine().simplified().split(' ');
+    if (header.size() != 4 || header[0] != "pslsession" || header[1].toUInt() != SessionRecorder::VERSION)
+        return fail(error, "not a session file");
+
+    auto canvas = window->Canvas();
+    if (header[2].toInt() != canvas->width() || header[3].toInt() != canvas->height())
+        qWarning("session recorded on a %sx%s canvas, playing on %dx%d",
+                 qPrintable(header[2]), qPrintable(header[3]), canvas->width(), canvas->height());
+
+    frames.clear();
+    canvas->RenderLayers();     // whatever the startup left dirty is not part of the session
+
+    QElapsedTimer clock;
+    clock.start();
+    for (int line = 2; !in.atEnd(); line++) {
+        auto record = in.readLine().trimmed();
+        if (record.isEmpty() || record.startsWith('#')) { continue; }
+
+        auto fields = record.split(' ');
+        auto msecs = fields[0].toLongLong();
+        auto name = fields.size() > 1 ? fields[1] : QString();
+        auto text = record.section(' ', 2);
+        auto arg = [&](int i) { return fields.size() > 2 + i ? fields[2 + i].toInt() : 0; };
+
+        if (realtime)
+            while (clock.elapsed() < msecs) {
+                QCoreApplication::processEvents(QEventLoop::AllEvents, 1);
+                QThread::msleep(1);
+            }
+
+        if (name == "press" || name == "move" || name == "release") {
+            auto type = name == "press" ? QEvent::MouseButtonPress
+                      : name == "move" ? QEvent::MouseMove
+                      : QEvent::MouseButtonRelease;
+            QMouseEvent e(type, QPointF(arg(0), arg(1)),
+                          static_cast<Qt::MouseButton>(arg(2)),
+                          static_cast<Qt::MouseButtons>(arg(3)), Qt::NoModifier);
+            auto& actions = type == QEvent::MouseButtonPress ? canvas->OnMousePressed
+                          : type == QEvent::MouseMove ? canvas->OnMouseMoved
+                          : canvas->OnMouseReleased;
+            for (auto action : actions)
+                action(&e);
+        }
+        else if (name == "key")
+            emit window->keyReleased(arg(0));
+        else if (name == "clear")
+            emit window->clearPressed();
+        else if (name == "edit")
+            emit window->editPressed();
+        else if (name == "shading")
+            emit window->shadingChanged(text);
+        else if (name == "aa")
+            emit window->antiAliasingChanged(arg(0) != 0);
+        else if (name == "visibility")
+            emit window->visibilityChanged(text);
+        else if (name == "texture")
+            emit window->textureChanged(text);
+        else if (name == "lod")
+            emit window->lodToleranceChanged(text.toDouble());
+        else if (name == "heatmap")
+            emit window->heatmapChanged(text);
+        else if (name == "shadows")
+            emit window->shadowsChanged(arg(0) != 0);
+        else if (name == "light")
+            emit window->lightingValueChanged(arg(0), arg(1), arg(2));
+        else if (name == "rotation")
+            emit window->cameraRotationChanged(arg(0), arg(1), arg(2));
+        else if (name == "clipping")
+            emit window->cameraClippingChanged(arg(0), arg(1));
+        else if (name == "limits")
+            emit window->cameraLimitsChanged(arg(0), arg(1), arg(2), arg(3));
+        else if (name == "fov")
+            emit window->cameraFovChanged(text.toDouble());
+        else if (name == "perspective")
+            emit window->cameraPerspectiveChanged(arg(0) != 0);
+        else
+            return fail(error, QString("malformed session at line %1").arg(line));
+
+        // the frame the record asked for
+        QElapsedTimer timer;
+        timer.start();
+        if (canvas->RenderLayers() > 0)
+            frames.push_back({msecs, timer.nsecsElapsed()});
+
+        if (!realtime)
+            QCoreApplication::processEvents();
+    }
+
+    return true;
+}
+
+// ==================================================================================================
+const std::vector<SessionPlayer::Frame>& SessionPlayer::Frames() const {
+    return frames;
+}
+
+// ==================================================================================================
+QString SessionPlayer::Summary() const {
+    if (frames.empty()) { return "no frames rendered"; }
+
+    std::vector<qint64> times;
+    qint64 total = 0;
+    for (auto& f : frames) {
+        times.push_back(f.nsecs);
+        total += f.nsecs;
+    }
+    std::sort(times.begin(), times.end());
+
+    auto ms = [](qint64 nsecs) { return QString::number(nsecs / 1e6, 'f', 2); };
+    return QString("%1 frames, mean %2 ms, median %3 ms, p95 %4 ms, worst %5 ms")
+            .arg(frames.size())
+            .arg(ms(total / static_cast<qint64>(frames.size())))
+            .arg(ms(times[times.size() / 2]))
+            .arg(ms(times[times.size() * 95 / 100]))
+            .arg(ms(times.back()));
+}
+
+// ==================================================================================================
+bool SessionPlayer::SaveTimings(const QString& path, QString* error) const {
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate | QFile::Text))
+        return fail(error, file.errorString());
+
+    QTextStream out(&file);
+    out << "msecs,nsecs\n";
+    for (auto& f : frames)
+        out << f.msecs << "," << f.nsecs << "\n";
+    return true;
+}
@@ -0,0 +1,38 @@
+#ifndef SESSIONPLAYER_H
+#define SESSIONPLAYER_H
+
+#include <QString>
+#include <vector>
+
+#include "mainwindow.h"
+
+// Feeds a session written by SessionRecorder back into the editor: mouse records go through
+// the canvas hooks and the others are emitted as the MainWindow signals they came from, so
+// AppController handles them as it did live. After every record the dirty canvas layers are
+// rendered offscreen and timed, no paint event or display involved. Played in real time the
+// records wait for their timestamps, otherwise they follow each other at once.
+class SessionPlayer
+{
+public:
+    struct Frame {
+        qint64 msecs;       // timestamp of the record that caused it
+        qint64 nsecs;       // spent rendering the dirty layers
+    };
+
+private:
+    MainWindow* window;
+    std::vector<Frame> frames;
+
+public:
+    explicit SessionPlayer(MainWindow* window);
+
+    bool Play(const QString& path, bool realtime, QString* error = nullptr);
+
+    const std::vector<Frame>& Frames() const;
+
+    // frame count, mean, median, 95th percentile and worst frame time
+    QString Summary() const;
+    bool SaveTimings(const QString& path, QString* error = nullptr) const;
+};
+
+#endif // SESSIONPLAYER_H
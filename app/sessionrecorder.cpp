@@ -0,0 +1,88 @@
+#include "sessionrecorder.h"
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+SessionRecorder::SessionRecorder(MainWindow* window) : window(window) {}
+
+// ==================================================================================================
+bool SessionRecorder::Start(const QString& path, QString* error) {
+    file.setFileName(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate | QFile::Text)) {
+        if (error != nullptr) { *error = file.errorString(); }
+        return false;
+    }
+    out.setDevice(&file);
+
+    auto canvas = window->Canvas();
+    out << "pslsession " << VERSION << " " << canvas->width() << " " << canvas->height() << "\n";
+    clock.start();
+
+    canvas->OnMousePressed.push_back([this](QMouseEvent* e) { writeMouse("press", e); });
+    canvas->OnMouseMoved.push_back([this](QMouseEvent* e) { writeMouse("move", e); });
+    canvas->OnMouseReleased.push_back([this](QMouseEvent* e) { writeMouse("release", e); });
+
+    connect(window, &MainWindow::keyReleased, this, [this](int key) {
+        write(QString("key %1").arg(key));
+    });
+    connect(window, &MainWindow::clearPressed, this, [this]() { write("clear"); });
+    connect(window, &MainWindow::editPressed, this, [this]() { write("edit"); });
+    connect(window, &MainWindow::shadingChanged, this, [this](const QString& s) {
+        write("shading " + s);
+    });
+    connect(window, &MainWindow::antiAliasingChanged, this, [this](bool on) {
+        write(QString("aa %1").arg(on ? 1 : 0));
+    });
+    connect(window, &MainWindow::visibilityChanged, this, [this](const QString& s) {
+        write("visibility " + s);
+    });
+    connect(window, &MainWindow::textureChanged, this, [this](const QString& s) {
+        write("texture " + s);
+    });
+    connect(window, &MainWindow::lodToleranceChanged, this, [this](double v) {
+        write(QString("lod %1").arg(v));
+    });
+    connect(window, &MainWindow::heatmapChanged, this, [this](const QString& s) {
+        write("heatmap " + s);
+    });
+    connect(window, &MainWindow::shadowsChanged, this, [this](bool on) {
+        write(QString("shadows %1").arg(on ? 1 : 0));
+    });
+    connect(window, &MainWindow::lightingValueChanged, this, [this](int x, int y, int z) {
+        write(QString("light %1 %2 %3").arg(x).arg(y).arg(z));
+    });
+    connect(window, &MainWindow::cameraRotationChanged, this, [this](int x, int y, int z) {
+        write(QString("rotation %1 %2 %3").arg(x).arg(y).arg(z));
+    });
+    connect(window, &MainWindow::cameraClippingChanged, this, [this](int nearZ, int farZ) {
+        write(QString("clipping %1 %2").arg(nearZ).arg(farZ));
+    });
+    connect(window, &MainWindow::cameraLimitsChanged, this, [this](int hMin, int hMax, int vMin, int vMax) {
+        write(QString("limits %1 %2 %3 %4").arg(hMin).arg(hMax).arg(vMin).arg(vMax));
+    });
+    connect(window, &MainWindow::cameraFovChanged, this, [this](double fovY) {
+        write(QString("fov %1").arg(fovY));
+    });
+    connect(window, &MainWindow::cameraPerspectiveChanged, this, [this](bool on) {
+        write(QString("perspective %1").arg(on ? 1 : 0));
+    });
+
+    return true;
+}
+
+// ==================================================================================================
+// PRIVATE MEMBERS
+// ==================================================================================================
+void SessionRecorder::write(const QString& record) {
+    // flushed at once, a session is most useful right after something went wrong
+    out << clock.elapsed() << " " << record << "\n";
+    out.flush();
+}
+
+// ==================================================================================================
+void SessionRecorder::writeMouse(const char* type, QMouseEvent* e) {
+    write(QString("%1 %2 %3 %4 %5").arg(type)
+          .arg(e->x()).arg(e->y())
+          .arg(static_cast<int>(e->button()))
+          .arg(static_cast<int>(e->buttons())));
+}
@@ -0,0 +1,48 @@
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <QObject>
+#include <QFile>
+#include <QTextStream>
+#include <QElapsedTimer>
+
+#include "mainwindow.h"
+
+// Writes what the user does in the editor to a session file: the mouse events reaching the
+// canvas and the signals of MainWindow, each with the milliseconds elapsed since the start.
+// SessionPlayer feeds them back through the same paths.
+//
+// Session files, one record per line:
+//   pslsession 1 <canvas width> <canvas height>
+//   <msecs> press|move|release <x> <y> <button> <buttons>
+//   <msecs> key <key>
+//   <msecs> clear | edit
+//   <msecs> shading|visibility|heatmap|texture <text, to the end of the line>
+//   <msecs> aa|perspective|shadows <0|1>
+//   <msecs> lod|fov <value>
+//   <msecs> light|rotation <x> <y> <z>
+//   <msecs> clipping <near> <far>
+//   <msecs> limits <hMin> <hMax> <vMin> <vMax>
+class SessionRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    static const uint32_t VERSION = 1;
+
+private:
+    MainWindow* window;
+    QFile file;
+    QTextStream out;
+    QElapsedTimer clock;
+
+public:
+    explicit SessionRecorder(MainWindow* window);
+
+    bool Start(const QString& path, QString* error = nullptr);
+
+private:
+    void write(const QString& record);
+    void writeMouse(const char* type, QMouseEvent* e);
+};
+
+#endif // SESSIONRECORDER_H
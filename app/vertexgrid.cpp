@@ -0,0 +1,100 @@
+#include "vertexgrid.h"
+#include <algorithm>
+#include <cmath>
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+VertexGrid::VertexGrid(int cellSize) : cellSize(cellSize) { }
+
+// ==================================================================================================
+void VertexGrid::Insert(QPoint* point, int id) {
+    auto k = keyOf(*point);
+    cells[k].push_back({point, id});
+    cellOf[point] = k;
+}
+
+// ==================================================================================================
+void VertexGrid::Remove(QPoint* point) {
+    auto it = cellOf.find(point);
+    if (it == cellOf.end()) { return; }
+
+    auto& cell = cells[it->second];
+    cell.erase(std::remove_if(cell.begin(), cell.end(),
+                              [point](const Entry& e) { return e.point == point; }),
+               cell.end());
+    if (cell.empty()) { cells.erase(it->second); }
+    cellOf.erase(it);
+}
+
+// ==================================================================================================
+void VertexGrid::Update(QPoint* point) {
+    auto it = cellOf.find(point);
+    if (it == cellOf.end()) { return; }
+
+    // most moves stay inside the same cell
+    auto k = keyOf(*point);
+    if (k == it->second) { return; }
+
+    auto& cell = cells[it->second];
+    auto entry = std::find_if(cell.begin(), cell.end(), [point](const Entry& e) { return e.point == point; });
+    auto moved = *entry;
+    cell.erase(entry);
+    if (cell.empty()) { cells.erase(it->second); }
+
+    cells[k].push_back(moved);
+    it->second = k;
+}
+
+// ==================================================================================================
+void VertexGrid::Clear() {
+    cells.clear();
+    cellOf.clear();
+}
+
+// ==================================================================================================
+int VertexGrid::Nearest(const QPoint& pos, int maxDistSquared) const {
+    int best = -1;
+    long long bestDist = static_cast<long long>(maxDistSquared) + 1;
+    int maxDist = static_cast<int>(ceil(sqrt(static_cast<double>(maxDistSquared))));
+
+    int x0 = cellCoord(pos.x() - maxDist), x1 = cellCoord(pos.x() + maxDist);
+    int y0 = cellCoord(pos.y() - maxDist), y1 = cellCoord(pos.y() + maxDist);
+
+    for (int cy = y0; cy <= y1; cy++)
+        for (int cx = x0; cx <= x1; cx++) {
+            auto cell = cells.find(key(cx, cy));
+            if (cell == cells.end()) { continue; }
+
+            for (auto& e : cell->second) {
+                long long dx = e.point->x() - pos.x();
+                long long dy = e.point->y() - pos.y();
+                auto dist = dx * dx + dy * dy;
+                // ties go to the lowest id, as the old linear scan did
+                if (dist < bestDist || (dist == bestDist && best >= 0 && e.id < best)) {
+                    best = e.id;
+                    bestDist = dist;
+                }
+            }
+        }
+
+    return best;
+}
+
+// ==================================================================================================
+// PRIVATE MEMBERS
+// ==================================================================================================
+uint64_t VertexGrid::key(int cx, int cy) const {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+}
+
+// ==================================================================================================
+uint64_t VertexGrid::keyOf(const QPoint& p) const {
+    return key(cellCoord(p.x()), cellCoord(p.y()));
+}
+
+// ==================================================================================================
+int VertexGrid::cellCoord(int v) const {
+    // floor division, so negative coordinates get their own cells
+    return v >= 0 ? v / cellSize : -((-v + cellSize - 1) / cellSize);
+}
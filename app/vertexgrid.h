@@ -0,0 +1,41 @@
+#ifndef VERTEXGRID_H
+#define VERTEXGRID_H
+
+#include <QPoint>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+// Uniform grid over the edited vertices, so hover and picking look at the few cells
+// around the cursor instead of every vertex. Points are indexed by pointer and identified
+// by the id given on insertion; whoever moves a point calls Update afterwards.
+class VertexGrid
+{
+private:
+    struct Entry {
+        QPoint* point;
+        int id;
+    };
+
+    int cellSize;
+    std::unordered_map<uint64_t, std::vector<Entry>> cells;
+    std::unordered_map<QPoint*, uint64_t> cellOf;
+
+public:
+    VertexGrid(int cellSize = 32);
+
+    void Insert(QPoint* point, int id);
+    void Remove(QPoint* point);
+    void Update(QPoint* point);
+    void Clear();
+
+    // id of the closest point whose squared distance to pos is at most maxDistSquared, -1 if none
+    int Nearest(const QPoint& pos, int maxDistSquared) const;
+
+private:
+    uint64_t key(int cx, int cy) const;
+    uint64_t keyOf(const QPoint& p) const;
+    int cellCoord(int v) const;
+};
+
+#endif // VERTEXGRID_H
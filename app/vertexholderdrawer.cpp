@@ -1,34 +1,31 @@
 #include "vertexholderdrawer.h"
 #include <vector>
 #include <QPoint>
-#include "linedrawer.h"
+#include "canvasopengl.h"
 
 #define QUAD_EXTENT 5
 
-VertexHolderDrawer::VertexHolderDrawer(CanvasOpenGL* canvas, QPoint* vertex) : Drawer(canvas){
+VertexHolderDrawer::VertexHolderDrawer(CanvasOpenGL* canvas, QPoint* vertex) : Drawer(canvas, HANDLES){
     this->vertex = vertex;
 }
 
 VertexHolderDrawer::~VertexHolderDrawer() {
 }
 
-void VertexHolderDrawer::Draw(QColor color) {
+// every handle of the layer goes through the same painter, one outline each
+void VertexHolderDrawer::Draw(QPainter& painter, QColor color) {
     if (IsHidden) return;
 
-    std::vector<QPoint> points = {
+    QPoint points[] = {
         QPoint(vertex->x() - QUAD_EXTENT, vertex->y()),
         QPoint(vertex->x(), vertex->y() + QUAD_EXTENT),
         QPoint(vertex->x() + QUAD_EXTENT, vertex->y()),
         QPoint(vertex->x(), vertex->y() - QUAD_EXTENT),
     };
 
-    LineDrawer drawer(canvas);
-    drawer.setWidth(isSelected ? 2 : 1);
-
-    for (size_t i = 0; i < 4; i++) {
-        drawer.Points = std::make_pair(&(points[i]), &(points[(i+1)%4]));
-        drawer.Draw(color);
-    }
+    painter.setPen(QPen(color, isSelected ? 2 : 1));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawPolygon(points, 4);
 }
 
 QPoint* VertexHolderDrawer::Vertex() const {
@@ -36,7 +33,9 @@ QPoint* VertexHolderDrawer::Vertex() const {
 }
 
 void VertexHolderDrawer::setIsSelected(const bool isSelected) {
+    if (this->isSelected == isSelected) return;
     this->isSelected = isSelected;
+    invalidate();
 }
 
 bool VertexHolderDrawer::IsSelected() const {
@@ -11,7 +11,7 @@ private:
 public:
     VertexHolderDrawer(CanvasOpenGL*, QPoint*);
     virtual ~VertexHolderDrawer();
-    virtual void Draw(QColor);
+    virtual void Draw(QPainter& painter, QColor);
 
     QPoint* Vertex() const;
 
@@ -1,11 +0,0 @@
-#ifndef CGUTILS_H
-#define CGUTILS_H
-
-#define clamp01(x) (x < 0 ? 0 : (x > 1 ? 1 : x))
-
-class CGUtils {
-public:
-
-};
-
-#endif // CGUTILS_H
@@ -0,0 +1,97 @@
+#include "abuffer.h"
+
+#include <algorithm>
+
+const uint32_t ABuffer::END;
+
+// ==================================================================================================
+// blends an opaque color over dst with an opacity in [0, 256], dst premultiplied
+static inline QRgb blendOver(QRgb src, QRgb dst, uint a) {
+    auto rb = (((src & 0xff00ff) * a + (dst & 0xff00ff) * (256 - a)) >> 8) & 0xff00ff;
+    auto ag = ((((src >> 8) & 0xff00ff) * a + ((dst >> 8) & 0xff00ff) * (256 - a)) >> 8) & 0xff00ff;
+    return rb | (ag << 8);
+}
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+void ABuffer::Reset(int height) {
+    pool.clear();
+    heads.assign(static_cast<size_t>(std::max(height, 0)), END);
+}
+
+// ==================================================================================================
+void ABuffer::Insert(int y, const SpanBuffer::Segment& span, int alpha) {
+    if (y < 0 || y >= static_cast<int>(heads.size()) || span.x1 < span.x0 || alpha <= 0) { return; }
+
+    auto& head = heads[static_cast<size_t>(y)];
+    pool.push_back({span, head, alpha + (alpha >> 7)});
+    head = static_cast<uint32_t>(pool.size() - 1);
+}
+
+// ==================================================================================================
+size_t ABuffer::SpanCount() const {
+    return pool.size();
+}
+
+// ==================================================================================================
+size_t ABuffer::Resolve(int y, QRgb* pixels, const int* depth, OverdrawCounters* counters) {
+    spans.clear();
+    for (auto i = heads[static_cast<size_t>(y)]; i != END; i = pool[i].next)
+        spans.push_back(&pool[i]);
+    if (spans.empty()) { return 0; }
+
+    // runs between every start and end of a span
+    std::sort(spans.begin(), spans.end(), [](const Node* a, const Node* b) { return a->span.x0 < b->span.x0; });
+    cuts.clear();
+    for (auto node : spans) {
+        cuts.push_back(node->span.x0);
+        cuts.push_back(node->span.x1 + 1);
+    }
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+    size_t next = 0;
+    size_t blended = 0;
+    active.clear();
+    for (size_t c = 0; c + 1 < cuts.size(); c++) {
+        int x0 = cuts[c];
+        int x1 = cuts[c + 1];
+
+        // the faces covering the run, in their depth order at the end of the previous run
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [x0](const Fragment& f) { return f.node->span.x1 < x0; }),
+                     active.end());
+        for (; next < spans.size() && spans[next]->span.x0 == x0; next++)
+            active.push_back({spans[next], 0, 0});
+        if (active.empty()) { continue; }
+
+        for (int x = x0; x < x1; x++) {
+            for (auto& f : active) {
+                auto& s = f.node->span;
+                auto dx = x - s.x0;
+                auto w = 1.0 / (s.q + s.dq * dx);
+                f.z = (s.aq[0] + s.daq[0] * dx) * w;
+                f.color = qRgb(qBound(0, static_cast<int>((s.aq[1] + s.daq[1] * dx) * w), 255),
+                               qBound(0, static_cast<int>((s.aq[2] + s.daq[2] * dx) * w), 255),
+                               qBound(0, static_cast<int>((s.aq[3] + s.daq[3] * dx) * w), 255));
+            }
+
+            // farthest first; faces only swap where they intersect, so this is nearly sorted
+            for (size_t m = 1; m < active.size(); m++)
+                for (size_t n = m; n > 0 && active[n].z > active[n-1].z; n--)
+                    std::swap(active[n], active[n-1]);
+
+            auto color = pixels[x];
+            for (auto& f : active) {
+                bool visible = f.z < depth[x];
+                if (counters != nullptr) { counters->Test(x, y, visible); }
+                if (!visible) { continue; }
+                color = blendOver(f.color, color, static_cast<uint>(f.node->alpha));
+                blended++;
+            }
+            pixels[x] = color;
+        }
+    }
+    return blended;
+}
@@ -0,0 +1,58 @@
+#ifndef ABUFFER_H
+#define ABUFFER_H
+
+#include <QColor>
+#include <vector>
+#include <cstdint>
+
+#include "spanbuffer.h"
+#include "overdrawcounters.h"
+
+// A-buffer for the translucent faces of a frame, blended in any order. Instead of a list of
+// fragments per pixel, every row keeps the spans the translucent faces cover on it (segments
+// ramped like the S-buffer's), appended to one pool linked per row by index; the pool is
+// emptied, not freed, every frame. A row is resolved on its own once the opaque faces are
+// drawn: its spans are cut where one starts or ends into runs covered by the same faces, and in
+// every run each pixel sorts the fragments of those faces by depth (nearly sorted from the
+// previous pixel) and blends them back to front over the opaque pixel, dropping the ones the
+// depth buffer hides. Fragments only ever exist for the row being resolved.
+class ABuffer
+{
+private:
+    static const uint32_t END = UINT32_MAX;
+
+    struct Node {
+        SpanBuffer::Segment span;
+        uint32_t next;      // next span of the row in the pool, or END
+        int alpha;          // 0..256
+    };
+
+    // a face covering the current run, and its fragment at the current pixel
+    struct Fragment {
+        const Node* node;
+        double z;
+        QRgb color;
+    };
+
+    std::vector<Node> pool;
+    std::vector<uint32_t> heads;    // first span of every row, or END
+
+    // scratch of Resolve
+    std::vector<const Node*> spans;
+    std::vector<int> cuts;
+    std::vector<Fragment> active;
+
+public:
+    void Reset(int height);
+
+    // a span of a face with opacity alpha (0..255), attributes z, r, g, b premultiplied by q
+    void Insert(int y, const SpanBuffer::Segment& span, int alpha);
+
+    size_t SpanCount() const;
+
+    // blends the spans of row y over its pixels where they are nearer than depth, returns the
+    // number of fragments blended
+    size_t Resolve(int y, QRgb* pixels, const int* depth, OverdrawCounters* counters);
+};
+
+#endif // ABUFFER_H
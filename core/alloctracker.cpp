@@ -0,0 +1,122 @@
+#include "alloctracker.h"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef PSL_ALLOC_TRACKING
+
+// plain data only: a thread_local with a constructor could allocate from inside operator new
+static thread_local AllocTracker::Counters counters;
+static thread_local AllocTracker::Stage stage;
+
+// every block carries its size in front, keeping the alignment malloc gives
+static const size_t HEADER = alignof(std::max_align_t);
+
+// ==================================================================================================
+static void* allocate(size_t size) noexcept {
+    auto block = static_cast<char*>(std::malloc(size + HEADER));
+    if (block == nullptr) { return nullptr; }
+
+    *reinterpret_cast<size_t*>(block) = size;
+    counters.count[stage]++;
+    counters.bytes[stage] += size;
+    counters.live += static_cast<ptrdiff_t>(size);
+    if (counters.live > counters.peak) { counters.peak = counters.live; }
+    return block + HEADER;
+}
+
+// ==================================================================================================
+static void release(void* p) noexcept {
+    if (p == nullptr) { return; }
+
+    auto block = static_cast<char*>(p) - HEADER;
+    counters.live -= static_cast<ptrdiff_t>(*reinterpret_cast<size_t*>(block));
+    std::free(block);
+}
+
+// ==================================================================================================
+void* operator new(size_t size) {
+    auto p = allocate(size);
+    if (p == nullptr) { throw std::bad_alloc(); }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    auto p = allocate(size);
+    if (p == nullptr) { throw std::bad_alloc(); }
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p) noexcept {
+    release(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    release(p);
+}
+
+#if defined(__cpp_sized_deallocation)
+void operator delete(void* p, size_t) noexcept {
+    release(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    release(p);
+}
+#endif
+
+#endif // PSL_ALLOC_TRACKING
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+bool AllocTracker::Enabled() {
+#ifdef PSL_ALLOC_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ==================================================================================================
+AllocTracker::Counters AllocTracker::Current() {
+#ifdef PSL_ALLOC_TRACKING
+    return counters;
+#else
+    return Counters();
+#endif
+}
+
+// ==================================================================================================
+void AllocTracker::ResetPeak() {
+#ifdef PSL_ALLOC_TRACKING
+    counters.peak = counters.live;
+#endif
+}
+
+// ==================================================================================================
+AllocTracker::Stage AllocTracker::Enter(Stage stage) {
+#ifdef PSL_ALLOC_TRACKING
+    auto previous = ::stage;
+    ::stage = stage;
+    return previous;
+#else
+    return stage;
+#endif
+}
@@ -0,0 +1,50 @@
+#ifndef ALLOCTRACKER_H
+#define ALLOCTRACKER_H
+
+#include <cstddef>
+
+// Heap use of the calling thread, counted by the global operator new and delete that
+// alloctracker.cpp replaces when built with CONFIG+=alloctracking (PSL_ALLOC_TRACKING).
+// Without it nothing is replaced and every counter stays 0. Allocations are tagged with the
+// stage of the innermost Scope alive on the thread.
+class AllocTracker
+{
+public:
+    enum Stage {
+        OTHER,
+        GEOMETRY,       // extrusion, clipping and projection
+        EDGE_TABLE,     // ET and AET
+        FILL,           // spans, shading and visibility
+        STAGE_COUNT
+    };
+
+    struct Counters {
+        size_t count[STAGE_COUNT];      // allocations
+        size_t bytes[STAGE_COUNT];      // bytes requested
+        ptrdiff_t live;                 // bytes allocated and not freed yet (by this thread)
+        ptrdiff_t peak;                 // largest live since ResetPeak
+    };
+
+    class Scope {
+#ifdef PSL_ALLOC_TRACKING
+        Stage previous;
+    public:
+        explicit Scope(Stage stage) : previous(Enter(stage)) {}
+        ~Scope() { Enter(previous); }
+#else
+    public:
+        explicit Scope(Stage) {}
+#endif
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    static bool Enabled();
+    static Counters Current();
+    static void ResetPeak();
+
+    // tags the next allocations of the thread, returns the previous stage
+    static Stage Enter(Stage stage);
+};
+
+#endif // ALLOCTRACKER_H
@@ -0,0 +1,171 @@
+#include "batchrenderer.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// ==================================================================================================
+static bool fail(QString* error, const QString& message) {
+    if (error != nullptr) { *error = message; }
+    return false;
+}
+
+// ==================================================================================================
+// frames waiting for an encoder; bounded, so a slow disk holds the workers back instead of
+// piling up images in memory
+class FrameQueue
+{
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::pair<size_t, QImage>> frames;
+    size_t capacity;
+    bool closed = false;
+
+public:
+    explicit FrameQueue(size_t capacity) : capacity(capacity) {}
+
+    void Push(size_t index, const QImage& image) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return frames.size() < capacity; });
+        frames.emplace_back(index, image);
+        changed.notify_all();
+    }
+
+    // false once the queue is closed and empty
+    bool Pop(size_t& index, QImage& image) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return closed || !frames.empty(); });
+        if (frames.empty()) { return false; }
+
+        index = frames.front().first;
+        image = frames.front().second;
+        frames.pop_front();
+        changed.notify_all();
+        return true;
+    }
+
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        changed.notify_all();
+    }
+};
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+bool BatchRenderer::LoadPath(const QString& path, std::vector<Key>& keys, QString* error) {
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+        return fail(error, file.errorString());
+
+    QTextStream in(&file);
+    auto header = in.readLine().simplified().split(' ');
+    if (header.size() != 2 || header[0] != "pslpath" || header[1].toUInt() != VERSION)
+        return fail(error, "not a camera path file");
+
+    keys.clear();
+    for (int line = 2; !in.atEnd(); line++) {
+        auto fields = in.readLine().simplified().split(' ');
+        if (fields[0].isEmpty() || fields[0].startsWith('#')) { continue; }
+
+        bool ok = fields[0] == "frame" && fields.size() == 7;
+        float v[6];
+        for (int i = 0; ok && i < 6; i++)
+            v[i] = fields[1 + i].toFloat(&ok);
+
+        if (!ok) {
+            keys.clear();
+            return fail(error, QString("malformed camera path at line %1").arg(line));
+        }
+        keys.push_back({QVector3D(v[0], v[1], v[2]), QVector3D(v[3], v[4], v[5])});
+    }
+
+    return true;
+}
+
+// ==================================================================================================
+std::vector<BatchRenderer::Key> BatchRenderer::Turntable(int frames, int width, int height) {
+    std::vector<Key> keys;
+    for (int i = 0; i < frames; i++)
+        keys.push_back({QVector3D(0, 360.0f * i / frames, 0), QVector3D(width/2, height/2, -100)});
+    return keys;
+}
+
+// ==================================================================================================
+bool BatchRenderer::Render(Scene& scene, const std::vector<Key>& keys, const Settings& settings,
+                           QString* error) {
+    auto cores = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    auto threads = settings.threads > 0 ? settings.threads : cores;
+    auto encoders = settings.encoders > 0 ? settings.encoders : std::max(threads / 4, 1);
+
+    int digits = 4;
+    for (auto n = keys.size(); n >= 10000; n /= 10)
+        digits++;
+
+    FrameQueue queue(static_cast<size_t>(2 * threads));
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        Camera camera(QVector3D(0, 0, 0), QVector3D(0, 0, 0));
+        camera.isPerspective = settings.perspective;
+        LightSet lights;
+        lights.Add(LightSource::Type::POINT, QVector3D(0, 0, 1));
+
+        PolygonRenderer renderer(&lights, &camera);
+        renderer.SetScene(&scene);
+        renderer.SetShading(settings.shading);
+        renderer.SetVisibility(settings.visibility);
+        renderer.SetAntiAliasing(settings.antiAliasing);
+        renderer.SetLodTolerance(settings.lodTolerance);
+        renderer.SetHeatmap(settings.heatmap);
+        renderer.SetShadows(settings.shadows);
+        renderer.SetShadowFilter(settings.shadowFilter);
+        FrameBuffer frame(settings.width, settings.height);
+
+        for (size_t i = next++; i < keys.size() && !failed; i = next++) {
+            auto rotation = keys[i].rotation;
+            camera.SetRotation(rotation);
+            lights.SetVector(0, keys[i].light);
+            renderer.Render(frame, QColor(255, 255, 255));
+
+            // the queue shares the image, the next Clear detaches the frame from it
+            queue.Push(i, frame.Image());
+        }
+    };
+
+    auto encoder = [&]() {
+        size_t index;
+        QImage image;
+        while (queue.Pop(index, image)) {
+            auto path = QString(settings.output).arg(static_cast<qulonglong>(index), digits, 10, QChar('0'));
+            if (!failed && !image.save(path, "PNG")) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!failed.exchange(true))
+                    fail(error, QString("could not write %1").arg(path));
+            }
+        }
+    };
+
+    std::vector<std::thread> encoderThreads, workerThreads;
+    for (int i = 0; i < encoders; i++)
+        encoderThreads.emplace_back(encoder);
+    for (int i = 0; i < threads; i++)
+        workerThreads.emplace_back(worker);
+
+    for (auto& t : workerThreads)
+        t.join();
+    queue.Close();
+    for (auto& t : encoderThreads)
+        t.join();
+
+    return !failed;
+}
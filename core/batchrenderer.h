@@ -0,0 +1,56 @@
+#ifndef BATCHRENDERER_H
+#define BATCHRENDERER_H
+
+#include <QString>
+#include <QVector3D>
+#include <vector>
+
+#include "polygonrenderer.h"
+#include "scene.h"
+
+// Offline rendering of a scene along a camera path, one PNG per frame.
+// Frames are independent: every worker thread owns a PolygonRenderer with its own camera, lights
+// and frame buffer (color and depth) and takes the next frame from a shared counter. Finished
+// images go through a bounded queue to a separate pool of encoder threads, so PNG compression
+// and disk writes overlap the rendering of the next frames.
+//
+// Camera path files, one record per line:
+//   pslpath 1
+//   frame rx ry rz lx ly lz            (camera rotation in degrees, point light position)
+class BatchRenderer
+{
+public:
+    static const uint32_t VERSION = 1;
+
+    struct Key {
+        QVector3D rotation;
+        QVector3D light;
+    };
+
+    struct Settings {
+        int width = 720;
+        int height = 480;
+        PolygonRenderer::Shading shading = PolygonRenderer::Shading::FLAT;
+        PolygonRenderer::Visibility visibility = PolygonRenderer::Visibility::ZBUFFER;
+        bool antiAliasing = false;
+        bool perspective = true;
+        float lodTolerance = 0.5f;
+        PolygonRenderer::Heatmap heatmap = PolygonRenderer::Heatmap::NONE;
+        bool shadows = false;
+        int shadowFilter = 1;               // PCF radius in texels, 0 for hard shadows
+        QString output = "frame_%1.png";    // %1 becomes the zero padded frame number
+        int threads = 0;                    // render workers, 0 uses every core
+        int encoders = 0;                   // PNG encoders, 0 uses a quarter of the workers
+    };
+
+    static bool LoadPath(const QString& path, std::vector<Key>& keys, QString* error = nullptr);
+
+    // a full turn around the y axis, lit from the viewer side like the editor
+    static std::vector<Key> Turntable(int frames, int width, int height);
+
+    // the scene is only read, by every worker at once
+    static bool Render(Scene& scene, const std::vector<Key>& keys, const Settings& settings,
+                       QString* error = nullptr);
+};
+
+#endif // BATCHRENDERER_H
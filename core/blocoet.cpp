@@ -0,0 +1,58 @@
+#include "blocoet.h"
+#include "cgutils.h"
+
+#include <iostream>
+
+BlocoET::BlocoET(double ymin, double ymax, double xmin, double xmax, double zmin, double zmax,
+                 double qmin, double qmax) {
+    this->first = CGUtils::FirstSample(ymin);
+    this->ymax = CGUtils::FirstSample(ymax);
+    this->dy = ymax - ymin;
+    this->step = first + 0.5 - ymin;
+
+    this->mx = (xmax - xmin) / dy;
+    this->mq = (qmax - qmin) / dy;
+    this->mz = (zmax * qmax - zmin * qmin) / dy;
+
+    this->x = xmin + step * mx;
+    this->q = qmin + step * mq;
+    this->z = zmin * qmin + step * mz;
+}
+
+BlocoET::BlocoET(double ymin, double ymax, double xmin, double xmax, double zmin, double zmax, double qmin, double qmax,
+                 double rmin, double rmax, double gmin, double gmax, double bmin, double bmax)
+    : BlocoET(ymin, ymax, xmin, xmax, zmin, zmax, qmin, qmax) {
+
+    this->mr = (rmax * qmax - rmin * qmin) / dy;
+    this->mg = (gmax * qmax - gmin * qmin) / dy;
+    this->mb = (bmax * qmax - bmin * qmin) / dy;
+
+    this->r = rmin * qmin + step * mr;
+    this->g = gmin * qmin + step * mg;
+    this->b = bmin * qmin + step * mb;
+}
+
+BlocoET::BlocoET(double ymin, double ymax, double xmin, double xmax, double zmin, double zmax, double qmin, double qmax,
+                 QVector3D &nmin, QVector3D &nmax)
+    : BlocoET(ymin, ymax, xmin, xmax, zmin, zmax, qmin, qmax) {
+    this->mn = (nmax * static_cast<float>(qmax) - nmin * static_cast<float>(qmin)) / static_cast<float>(dy);
+    this->n = nmin * static_cast<float>(qmin) + mn * static_cast<float>(step);
+}
+
+BlocoET::BlocoET(double ymin, double ymax, double xmin, double xmax, double zmin, double zmax, double qmin, double qmax,
+                 const QVector2D& uvmin, const QVector2D& uvmax)
+    : BlocoET(ymin, ymax, xmin, xmax, zmin, zmax, qmin, qmax) {
+    this->mu = (uvmax.x() * qmax - uvmin.x() * qmin) / dy;
+    this->mv = (uvmax.y() * qmax - uvmin.y() * qmin) / dy;
+
+    this->u = uvmin.x() * qmin + step * mu;
+    this->v = uvmin.y() * qmin + step * mv;
+}
+
+bool BlocoET::operator < (BlocoET obj){
+    if(this->x < obj.x)
+        return true;
+    else {
+        return false;
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef BLOCOET_H
+#define BLOCOET_H
+
+#include <QVector2D>
+#include <QVector3D>
+
+// Attributes are stored premultiplied by the perspective weight q = 1/w, which is what
+// stays linear in screen space; the span recovers them with a divide by q.
+// The edge runs from (xmin, ymin) to (xmax, ymax) with sub-pixel endpoints and is active on
+// rows first .. ymax - 1 (CGUtils::FirstSample); x and the attributes start at the center of
+// the first row, not at the vertex.
+class BlocoET
+{
+public:
+    int first, ymax;
+    double x, mx;
+    double q, mq;
+    double z, mz;
+    double r, g, b, mr, mg, mb;
+    QVector3D n, mn;
+    double u, v, mu, mv;
+
+    BlocoET(double ymin, double ymax, double xmin, double xmax, double zmin, double zmax,
+            double qmin = 1, double qmax = 1);
+
+    // GOURAUD
+    BlocoET(double ymin, double ymax, double xmin, double xmax, double zmin, double zmax, double qmin, double qmax,
+            double rmin, double rmax, double gmin, double gmax, double bmin, double bmax);
+
+    // PHONG
+    BlocoET(double ymin, double ymax, double xmin, double xmax, double zmin, double zmax, double qmin, double qmax,
+            QVector3D& nmin, QVector3D& nmax);
+
+    // TEXTURE
+    BlocoET(double ymin, double ymax, double xmin, double xmax, double zmin, double zmax, double qmin, double qmax,
+            const QVector2D& uvmin, const QVector2D& uvmax);
+
+    bool operator < (BlocoET obj);
+
+private:
+    double dy, step;    // height of the edge, and from its top vertex to the first row
+};
+
+#endif // BLOCOET_H
@@ -0,0 +1,55 @@
+#include "camera.h"
+#include <QMatrix4x4>
+#include <QtMath>
+
+Camera::Camera(QVector3D pos, QVector3D rot) :pos(pos), rot(rot),
+    hMin(0), hMax(0), vMin(0), vMax(0), nearZ(1), farZ(10000), aspect(0), fovY(60) { }
+
+QVector3D Camera::GetPosition() const {
+    return this->pos;
+}
+
+QVector3D Camera::GetRotation() const {
+    return this->rot;
+}
+
+void Camera::SetRotation(QVector3D& euler) {
+    this->rot = euler;
+}
+
+void Camera::Translate(QVector3D &dt) {
+    pos += dt;
+}
+
+void Camera::Rotate(QVector3D &dr) {
+    rot += dr;
+}
+
+Projection Camera::GetProjection(int width, int height) const {
+    Projection p;
+    p.cx = width / 2;
+    p.cy = height / 2;
+    p.sx = 1;
+    p.sy = 1;
+    p.eye = 0;
+    p.nearW = static_cast<float>(nearZ);
+    p.farW = static_cast<float>(farZ);
+
+    if (isPerspective) {
+        // the z = 0 plane keeps the scale of the orthographic view
+        p.eye = static_cast<float>(height / 2.0 / qTan(qDegreesToRadians(fovY) / 2));
+        if (aspect > 0 && height > 0)
+            p.sx = static_cast<float>(width / static_cast<double>(height) / aspect);
+        return p;
+    }
+
+    if (hMax > hMin) {
+        p.sx = static_cast<float>(width / (hMax - hMin));
+        p.cx = static_cast<float>(-hMin) * p.sx;
+    }
+    if (vMax > vMin) {
+        p.sy = static_cast<float>(height / (vMax - vMin));
+        p.cy = static_cast<float>(-vMin) * p.sy;
+    }
+    return p;
+}
@@ -0,0 +1,63 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <QVector3D>
+
+// Maps view space (centered on the viewport, y down, +z away from the viewer) to screen space.
+// Screen z stays the view depth; q = eye / w is the perspective weight, 1 on the z = 0 plane
+// and everywhere for an orthographic camera. Attributes interpolated as a*q and q are linear
+// in screen space.
+struct Projection {
+    float cx, cy;       // screen position of the view origin
+    float sx, sy;       // view units to pixels
+    float eye;          // eye distance from the z = 0 plane, 0 when orthographic
+    float nearW;        // smallest w kept by the near plane
+    float farW;         // largest w kept by the far plane
+
+    inline bool Perspective() const { return eye > 0; }
+
+    inline float W(const QVector3D& v) const {
+        return eye > 0 ? v.z() + eye : 1;
+    }
+
+    inline QVector3D Project(const QVector3D& v, float& q) const {
+        q = eye > 0 ? eye / (v.z() + eye) : 1;
+        return QVector3D(cx + v.x() * q * sx, cy + v.y() * q * sy, v.z());
+    }
+
+    // view space position of a screen point, whose z is still the view depth
+    inline QVector3D Unproject(const QVector3D& s) const {
+        auto q = eye > 0 ? eye / (s.z() + eye) : 1;
+        return QVector3D((s.x() - cx) / (q * sx), (s.y() - cy) / (q * sy), s.z());
+    }
+};
+
+class Camera
+{
+private:
+    QVector3D pos;
+    QVector3D rot;
+
+public:
+    double
+        hMin,   hMax,
+        vMin,   vMax,
+        nearZ,  farZ,
+        aspect, fovY;
+    bool isPerspective = true;     // fovY in degrees, aspect 0 follows the viewport
+                                   // hMin == hMax or vMin == vMax maps 1 unit to 1 pixel
+
+public:
+    Camera(QVector3D pos, QVector3D rot);
+
+    QVector3D GetPosition() const;
+    QVector3D GetRotation() const;
+    void SetRotation(QVector3D& );
+
+    Projection GetProjection(int width, int height) const;
+
+    void Translate(QVector3D&);
+    void Rotate(QVector3D&);
+};
+
+#endif // CAMERA_H
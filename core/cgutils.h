@@ -0,0 +1,19 @@
+#ifndef CGUTILS_H
+#define CGUTILS_H
+
+#include <cmath>
+
+#define clamp01(x) (x < 0 ? 0 : (x > 1 ? 1 : x))
+
+class CGUtils {
+public:
+    // Pixels are sampled at their centers. FirstSample(c) is the first pixel whose center is at
+    // or past c, so an edge from y0 to y1 covers rows FirstSample(y0) .. FirstSample(y1) - 1 and a
+    // span from x0 to x1 the pixels FirstSample(x0) .. FirstSample(x1) - 1. A center lying exactly
+    // on a top or left edge is inside, one on a bottom or right edge is not (top-left rule), so
+    // two faces sharing an edge never both cover a pixel of it.
+    static inline int FirstSample(double c) { return static_cast<int>(std::ceil(c - 0.5)); }
+
+};
+
+#endif // CGUTILS_H
@@ -0,0 +1,22 @@
+# include()d by the clients of the core library
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+CONFIG += c++11 thread
+alloctracking: DEFINES += PSL_ALLOC_TRACKING
+
+win32:CONFIG(release, debug|release) {
+    LIBS += -L$$OUT_PWD/../core/release/ -lPolygonScanLineCore
+    win32-g++: PRE_TARGETDEPS += $$OUT_PWD/../core/release/libPolygonScanLineCore.a
+    else: PRE_TARGETDEPS += $$OUT_PWD/../core/release/PolygonScanLineCore.lib
+}
+else:win32:CONFIG(debug, debug|release) {
+    LIBS += -L$$OUT_PWD/../core/debug/ -lPolygonScanLineCore
+    win32-g++: PRE_TARGETDEPS += $$OUT_PWD/../core/debug/libPolygonScanLineCore.a
+    else: PRE_TARGETDEPS += $$OUT_PWD/../core/debug/PolygonScanLineCore.lib
+}
+else {
+    LIBS += -L$$OUT_PWD/../core/ -lPolygonScanLineCore
+    PRE_TARGETDEPS += $$OUT_PWD/../core/libPolygonScanLineCore.a
+}
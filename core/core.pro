@@ -0,0 +1,69 @@
+# The scanline engine: geometry stage, edge tables, span fills, shading and scene files.
+# Only QtCore and QtGui (QImage, QPainter, QVector3D, QMatrix4x4) are used.
+
+QT       = core gui
+
+TARGET = PolygonScanLineCore
+TEMPLATE = lib
+CONFIG += staticlib c++11
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# qmake CONFIG+=alloctracking counts the heap use of every frame (see alloctracker.h)
+alloctracking: DEFINES += PSL_ALLOC_TRACKING
+
+# lets the SoA lighting and fill loops be vectorized
+gcc|clang: QMAKE_CXXFLAGS_RELEASE += -O3
+
+SOURCES += \
+    camera.cpp \
+    cgutils.cpp \
+    lightsource.cpp \
+    polygonrenderer.cpp \
+    blocoet.cpp \
+    framebuffer.cpp \
+    scene.cpp \
+    sceneio.cpp \
+    edgecoverage.cpp \
+    lightset.cpp \
+    scanlinevisibility.cpp \
+    spanbuffer.cpp \
+    texture.cpp \
+    outlinelod.cpp \
+    batchrenderer.cpp \
+    overdrawcounters.cpp \
+    alloctracker.cpp \
+    spanrasterizer.cpp \
+    pointclassifier.cpp \
+    model.cpp \
+    modelio.cpp \
+    abuffer.cpp \
+    shadowmap.cpp
+
+HEADERS += \
+    camera.h \
+    cgutils.h \
+    lightsource.h \
+    polygonrenderer.h \
+    blocoet.h \
+    framebuffer.h \
+    renderstats.h \
+    mesh.h \
+    scene.h \
+    sceneio.h \
+    edgecoverage.h \
+    lightset.h \
+    spanstepper.h \
+    scanlinevisibility.h \
+    spanbuffer.h \
+    texture.h \
+    outlinelod.h \
+    batchrenderer.h \
+    overdrawcounters.h \
+    alloctracker.h \
+    spanrasterizer.h \
+    pointclassifier.h \
+    model.h \
+    modelio.h \
+    abuffer.h \
+    shadowmap.h
@@ -0,0 +1,138 @@
+#include "edgecoverage.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+void EdgeCoverage::Reset() {
+    edges.clear();
+    active.clear();
+    next = 0;
+    top = 0;
+    bottom = 0;
+    sorted = false;
+}
+
+// ==================================================================================================
+void EdgeCoverage::AddEdge(double xa, double ya, double xb, double yb) {
+    if (ya == yb) { return; }   // horizontal edges cover nothing
+
+    Edge e;
+    if (ya < yb) { e = {xa, ya, xb, yb, 1.0f}; }
+    else         { e = {xb, yb, xa, ya, -1.0f}; }
+
+    if (edges.empty()) {
+        top = e.y0;
+        bottom = e.y1;
+    }
+    top = std::min(top, e.y0);
+    bottom = std::max(bottom, e.y1);
+
+    edges.push_back(e);
+}
+
+// ==================================================================================================
+int EdgeCoverage::Top() const {
+    return static_cast<int>(floor(top));
+}
+
+// ==================================================================================================
+int EdgeCoverage::Bottom() const {
+    return static_cast<int>(ceil(bottom));
+}
+
+// ==================================================================================================
+const std::vector<EdgeCoverage::Cell>& EdgeCoverage::Row(int y, int width) {
+    if (!sorted) {
+        std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.y0 < b.y0; });
+        sorted = true;
+    }
+
+    double ya = y;
+    double yb = y + 1.0;
+
+    // activates the edges starting above the bottom of the row, drops the ones ending above its top
+    while (next < edges.size() && edges[next].y0 < yb)
+        active.push_back(next++);
+    active.erase(std::remove_if(active.begin(), active.end(),
+                                [this, ya](size_t i) { return edges[i].y1 <= ya; }),
+                 active.end());
+
+    cells.clear();
+    for (auto i : active) {
+        auto& e = edges[i];
+        addCells(e, std::max(ya, e.y0), std::min(yb, e.y1), width);
+    }
+
+    std::sort(cells.begin(), cells.end(), [](const Cell& a, const Cell& b) { return a.x < b.x; });
+
+    // merges the cells of the same pixel
+    size_t out = 0;
+    for (size_t i = 0; i < cells.size(); i++) {
+        if (out > 0 && cells[out - 1].x == cells[i].x) {
+            cells[out - 1].area += cells[i].area;
+            cells[out - 1].cover += cells[i].cover;
+        }
+        else {
+            cells[out++] = cells[i];
+        }
+    }
+    cells.resize(out);
+
+    return cells;
+}
+
+// ==================================================================================================
+// PRIVATE MEMBERS
+// ==================================================================================================
+// splits the part of the edge between ya and yb at every pixel column it crosses
+void EdgeCoverage::addCells(const Edge& e, double ya, double yb, int width) {
+    if (yb <= ya) { return; }
+
+    auto dxdy = (e.x1 - e.x0) / (e.y1 - e.y0);
+    auto xa = e.x0 + (ya - e.y0) * dxdy;
+    auto xb = e.x0 + (yb - e.y0) * dxdy;
+    auto dir = static_cast<double>(e.dir);
+
+    auto ca = static_cast<int>(floor(xa));
+    auto cb = static_cast<int>(floor(xb));
+
+    if (ca == cb) {
+        addCell(ca, dir * (yb - ya), xa - ca, xb - ca, width);
+        return;
+    }
+
+    // walks columns from xa to xb, in whichever direction the edge leans
+    int step = cb > ca ? 1 : -1;
+    auto dydx = 1.0 / dxdy;
+    auto x = xa;
+    auto y = ya;
+    for (int c = ca; ; c += step) {
+        auto boundary = step > 0 ? c + 1.0 : static_cast<double>(c);
+        auto last = c == cb;
+        auto xn = last ? xb : boundary;
+        auto yn = last ? yb : ya + (boundary - xa) * dydx;
+
+        addCell(c, dir * (yn - y), x - c, xn - c, width);
+        if (last) { break; }
+
+        x = xn;
+        y = yn;
+    }
+}
+
+// ==================================================================================================
+void EdgeCoverage::addCell(int x, double dy, double fx0, double fx1, int width) {
+    if (x >= width) { return; }     // nothing visible to its right
+
+    // left of the target the pixel itself is invisible, only its cover carries over
+    if (x < 0) {
+        cells.push_back({-1, 0.0f, static_cast<float>(dy)});
+        return;
+    }
+
+    auto area = dy * (1.0 - 0.5 * (fx0 + fx1));
+    cells.push_back({x, static_cast<float>(area), static_cast<float>(dy)});
+}
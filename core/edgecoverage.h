@@ -0,0 +1,54 @@
+#ifndef EDGECOVERAGE_H
+#define EDGECOVERAGE_H
+
+#include <vector>
+#include <cstddef>
+
+// Exact area coverage of a polygon, one scanline at a time.
+// Every edge crossing the row band [y, y+1] deposits, on each pixel column it passes through,
+// the area it covers inside that pixel ("area") and the height it spans ("cover", which also
+// covers every pixel to its right). Sweeping the sorted cells of a row left to right then gives
+// the exact coverage of each edge pixel, and a constant coverage for the runs between cells.
+// Winding is signed, so holes wound against their outline cancel out (non-zero rule).
+class EdgeCoverage
+{
+public:
+    struct Cell {
+        int x;
+        float area;
+        float cover;
+    };
+
+private:
+    struct Edge {
+        double x0, y0;          // top end
+        double x1, y1;          // bottom end
+        float dir;              // +1 if the edge runs downwards in loop order, -1 otherwise
+    };
+
+    std::vector<Edge> edges;
+    std::vector<size_t> active;
+    std::vector<Cell> cells;
+    size_t next = 0;
+    double top = 0;
+    double bottom = 0;
+    bool sorted = false;
+
+public:
+    void Reset();
+    void AddEdge(double xa, double ya, double xb, double yb);
+
+    // first and one past the last row touched by the edges
+    int Top() const;
+    int Bottom() const;
+
+    // cells of row y sorted by x, merged per pixel; cells left of the target are folded into x = -1.
+    // Rows must be requested in increasing order.
+    const std::vector<Cell>& Row(int y, int width);
+
+private:
+    void addCells(const Edge& e, double ya, double yb, int width);
+    void addCell(int x, double dy, double fx0, double fx1, int width);
+};
+
+#endif // EDGECOVERAGE_H
@@ -0,0 +1,51 @@
+#include "framebuffer.h"
+
+const int FrameBuffer::FAR_DEPTH;
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+FrameBuffer::FrameBuffer(int width, int height) {
+    Resize(width, height);
+}
+
+// ==================================================================================================
+void FrameBuffer::Resize(int width, int height) {
+    if (width == this->width && height == this->height && !image.isNull()) { return; }
+
+    this->width = width;
+    this->height = height;
+    image = QImage(width, height, QImage::Format_ARGB32_Premultiplied);
+    depth.assign(static_cast<size_t>(width) * static_cast<size_t>(height), FAR_DEPTH);
+}
+
+// ==================================================================================================
+void FrameBuffer::Clear(QRgb background) {
+    image.fill(background);
+    ClearDepth();
+}
+
+// ==================================================================================================
+void FrameBuffer::ClearDepth() {
+    std::fill(depth.begin(), depth.end(), FAR_DEPTH);
+}
+
+// ==================================================================================================
+int FrameBuffer::Width() const {
+    return width;
+}
+
+// ==================================================================================================
+int FrameBuffer::Height() const {
+    return height;
+}
+
+// ==================================================================================================
+QImage& FrameBuffer::Image() {
+    return image;
+}
+
+// ==================================================================================================
+const QImage& FrameBuffer::Image() const {
+    return image;
+}
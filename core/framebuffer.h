@@ -0,0 +1,45 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <QImage>
+#include <algorithm>
+#include <vector>
+
+// Offscreen render target: a color image plus a row-major depth buffer of the same size.
+// The rasterizer only ever writes here, so a frame can be rendered without a widget
+// (golden images, benchmarks) and the canvas just blits the result.
+class FrameBuffer
+{
+public:
+    static const int FAR_DEPTH = 10000000; // todo: camera far / near
+
+private:
+    int width = 0;
+    int height = 0;
+    QImage image;
+    std::vector<int> depth;
+
+public:
+    FrameBuffer(int width = 0, int height = 0);
+
+    void Resize(int width, int height);
+    void Clear(QRgb background = 0);
+    void ClearDepth();
+
+    int Width() const;
+    int Height() const;
+
+    QImage& Image();
+    const QImage& Image() const;
+
+    inline int& Depth(int x, int y) {
+        return depth[static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)];
+    }
+
+    // premultiplied ARGB pixels of row y, for fills that bypass QPainter
+    inline QRgb* Row(int y) {
+        return reinterpret_cast<QRgb*>(image.scanLine(y));
+    }
+};
+
+#endif // FRAMEBUFFER_H
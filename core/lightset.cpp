@@ -0,0 +1,154 @@
+#include "lightset.h"
+
+#include <cmath>
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+size_t LightSet::Add(LightSource::Type type, const QVector3D& vector, QColor color, double intensity) {
+    x.push_back(0);
+    y.push_back(0);
+    z.push_back(0);
+    isPoint.push_back(type == LightSource::Type::POINT ? 1.0f : 0.0f);
+    r.push_back(0);
+    g.push_back(0);
+    b.push_back(0);
+
+    auto i = x.size() - 1;
+    SetVector(i, vector);
+    SetColor(i, color, intensity);
+    return i;
+}
+
+// ==================================================================================================
+void LightSet::SetVector(size_t i, const QVector3D& vector) {
+    // directions are used normalized, positions as they are
+    auto v = isPoint[i] > 0 ? vector : vector.normalized();
+    x[i] = v.x();
+    y[i] = v.y();
+    z[i] = v.z();
+}
+
+// ==================================================================================================
+void LightSet::SetColor(size_t i, QColor color, double intensity) {
+    r[i] = static_cast<float>(color.redF() * intensity);
+    g[i] = static_cast<float>(color.greenF() * intensity);
+    b[i] = static_cast<float>(color.blueF() * intensity);
+}
+
+// ==================================================================================================
+void LightSet::Clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+    isPoint.clear();
+    r.clear();
+    g.clear();
+    b.clear();
+}
+
+// ==================================================================================================
+size_t LightSet::Size() const {
+    return x.size();
+}
+
+// ==================================================================================================
+LightSource::Type LightSet::Type(size_t i) const {
+    return isPoint[i] > 0 ? LightSource::Type::POINT : LightSource::Type::DIRECTIONAL;
+}
+
+// ==================================================================================================
+QVector3D LightSet::Vector(size_t i) const {
+    return QVector3D(x[i], y[i], z[i]);
+}
+
+// ==================================================================================================
+// Same model as LightSource::FullLighting, summed over all lights:
+//      diffuse  += color * clamp01(l.n)
+//      specular += color * clamp01(s.r) ^ shininess,   r = 2(l.n)n - l
+// both scaled by the shadow of the sample for the shadowed light
+void LightSet::Evaluate(LightBatch& batch, const QVector3D& view, double shininess) const {
+    auto n = batch.count;
+    auto vx = view.x(), vy = view.y(), vz = view.z();
+
+    // per sample setup, once for all lights
+    for (size_t i = 0; i < n; i++) {
+        auto nl = batch.nx[i] * batch.nx[i] + batch.ny[i] * batch.ny[i] + batch.nz[i] * batch.nz[i];
+        auto ninv = nl > 0 ? 1.0f / sqrtf(nl) : 0.0f;
+        batch.nx[i] *= ninv;
+        batch.ny[i] *= ninv;
+        batch.nz[i] *= ninv;
+
+        auto sx = vx - batch.px[i], sy = vy - batch.py[i], sz = vz - batch.pz[i];
+        auto sl = sx * sx + sy * sy + sz * sz;
+        auto sinv = sl > 0 ? 1.0f / sqrtf(sl) : 0.0f;
+        batch.sx[i] = sx * sinv;
+        batch.sy[i] = sy * sinv;
+        batch.sz[i] = sz * sinv;
+
+        batch.diffR[i] = batch.diffG[i] = batch.diffB[i] = 0;
+        batch.specR[i] = batch.specG[i] = batch.specB[i] = 0;
+    }
+
+    // integral exponents (the usual case) are done by squaring, which stays vectorizable
+    auto exponent = static_cast<int>(shininess);
+    bool integral = exponent == shininess && exponent >= 0;
+    auto sh = static_cast<float>(shininess);
+
+    for (size_t l = 0; l < x.size(); l++) {
+        auto lx = x[l], ly = y[l], lz = z[l], pt = isPoint[l];
+        auto cr = r[l], cg = g[l], cb = b[l];
+        bool occluded = static_cast<int>(l) == batch.shadowed;
+
+        for (size_t i = 0; i < n; i++) {
+            auto dx = lx - pt * batch.px[i];
+            auto dy = ly - pt * batch.py[i];
+            auto dz = lz - pt * batch.pz[i];
+            auto dl = dx * dx + dy * dy + dz * dz;
+            auto dinv = dl > 0 ? 1.0f / sqrtf(dl) : 0.0f;
+            dx *= dinv;
+            dy *= dinv;
+            dz *= dinv;
+
+            auto dot = dx * batch.nx[i] + dy * batch.ny[i] + dz * batch.nz[i];
+            auto cosTheta = dot < 0 ? 0.0f : (dot > 1 ? 1.0f : dot);
+            auto visible = occluded ? batch.shadow[i] : 1.0f;
+
+            auto rx = 2 * dot * batch.nx[i] - dx;
+            auto ry = 2 * dot * batch.ny[i] - dy;
+            auto rz = 2 * dot * batch.nz[i] - dz;
+            auto cosAlpha = batch.sx[i] * rx + batch.sy[i] * ry + batch.sz[i] * rz;
+            batch.cosA[i] = cosAlpha < 0 ? 0.0f : (cosAlpha > 1 ? 1.0f : cosAlpha);
+
+            batch.diffR[i] += cr * cosTheta * visible;
+            batch.diffG[i] += cg * cosTheta * visible;
+            batch.diffB[i] += cb * cosTheta * visible;
+        }
+
+        if (integral) {
+            for (size_t i = 0; i < n; i++)
+                batch.power[i] = 1;
+            for (auto e = exponent; e > 0; e >>= 1) {
+                if (e & 1)
+                    for (size_t i = 0; i < n; i++)
+                        batch.power[i] *= batch.cosA[i];
+                for (size_t i = 0; i < n; i++)
+                    batch.cosA[i] *= batch.cosA[i];
+            }
+        }
+        else {
+            for (size_t i = 0; i < n; i++)
+                batch.power[i] = powf(batch.cosA[i], sh);
+        }
+
+        if (occluded)
+            for (size_t i = 0; i < n; i++)
+                batch.power[i] *= batch.shadow[i];
+
+        for (size_t i = 0; i < n; i++) {
+            batch.specR[i] += cr * batch.power[i];
+            batch.specG[i] += cg * batch.power[i];
+            batch.specB[i] += cb * batch.power[i];
+        }
+    }
+}
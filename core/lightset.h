@@ -0,0 +1,66 @@
+#ifndef LIGHTSET_H
+#define LIGHTSET_H
+
+#include <QColor>
+#include <QVector3D>
+#include <vector>
+
+#include "lightsource.h"
+
+// A batch of shading samples (positions and normals) and, after LightSet::Evaluate,
+// the diffuse and specular light reaching each of them, per color channel.
+struct LightBatch {
+    static const size_t CAPACITY = 64;
+
+    size_t count = 0;
+    float px[CAPACITY], py[CAPACITY], pz[CAPACITY];
+    float nx[CAPACITY], ny[CAPACITY], nz[CAPACITY];
+
+    float diffR[CAPACITY], diffG[CAPACITY], diffB[CAPACITY];
+    float specR[CAPACITY], specG[CAPACITY], specB[CAPACITY];
+
+    // per sample setup shared by every light
+    float sx[CAPACITY], sy[CAPACITY], sz[CAPACITY];
+    float cosA[CAPACITY], power[CAPACITY];
+
+    // fraction of light `shadowed` reaching each sample (see ShadowMap), -1 when none is
+    int shadowed = -1;
+    float shadow[CAPACITY];
+
+    inline void Push(const QVector3D& p, const QVector3D& n) {
+        px[count] = p.x(); py[count] = p.y(); pz[count] = p.z();
+        nx[count] = n.x(); ny[count] = n.y(); nz[count] = n.z();
+        count++;
+    }
+
+    inline bool Full() const { return count == CAPACITY; }
+};
+
+// Any number of point and directional lights, each with a color and an intensity,
+// kept as structure of arrays. Evaluate runs every light over a whole batch of samples:
+// the per sample setup (normalizing the normal and the view direction) is done once and
+// the loop over samples is a plain float loop over contiguous arrays, which the compiler
+// turns into SIMD code.
+class LightSet
+{
+private:
+    std::vector<float> x, y, z;         // position of point lights, direction of directional ones
+    std::vector<float> isPoint;         // 1 for point lights, 0 for directional ones
+    std::vector<float> r, g, b;         // color * intensity
+
+public:
+    size_t Add(LightSource::Type type, const QVector3D& vector,
+               QColor color = QColor(255, 255, 255), double intensity = 1.0);
+    void SetVector(size_t i, const QVector3D& vector);
+    void SetColor(size_t i, QColor color, double intensity = 1.0);
+    void Clear();
+    size_t Size() const;
+
+    LightSource::Type Type(size_t i) const;
+    // position of a point light, normalized direction of a directional one
+    QVector3D Vector(size_t i) const;
+
+    void Evaluate(LightBatch& batch, const QVector3D& view, double shininess) const;
+};
+
+#endif // LIGHTSET_H
@@ -0,0 +1,94 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <QColor>
+#include <QVector2D>
+#include <QVector3D>
+#include <vector>
+#include <cstdint>
+
+class Texture;
+
+// A face is one or more closed loops of vertex indices (the first loop is the outline,
+// the others are holes), stored as a range of Mesh::indices. Loop ends live in Mesh::loopEnds.
+struct Face {
+    uint32_t first;
+    uint32_t count;
+    uint32_t loop;
+    uint32_t loops;
+    QColor color;
+    const Texture* texture;     // replaces color when set (not owned)
+    bool convex;                // one convex loop, filled by the two-edge walk
+};
+
+// Geometry of every polygon of a frame, flattened into shared arrays.
+// Points are in screen space once the geometry stage ran, with the view depth as z and
+// their perspective weight q = 1/w in weights; normals are per vertex. Texture coordinates
+// are per corner (a vertex shared by a cap and a side wall maps differently on each), so uvs
+// runs parallel to indices.
+struct Mesh {
+    std::vector<QVector3D> points;
+    std::vector<QVector3D> normals;
+    std::vector<float> weights;
+    std::vector<uint32_t> indices;
+    std::vector<QVector2D> uvs;
+    std::vector<uint32_t> loopEnds;
+    std::vector<Face> faces;
+
+    void Clear() {
+        points.clear();
+        normals.clear();
+        weights.clear();
+        indices.clear();
+        uvs.clear();
+        loopEnds.clear();
+        faces.clear();
+    }
+
+    // opens a face, the indices pushed next belong to its first loop
+    void BeginFace(const QColor& color, const Texture* texture = nullptr, bool convex = false) {
+        faces.push_back({static_cast<uint32_t>(indices.size()), 0,
+                         static_cast<uint32_t>(loopEnds.size()), 0, color, texture, convex});
+    }
+
+    inline void Corner(uint32_t index, const QVector2D& uv) {
+        indices.push_back(index);
+        uvs.push_back(uv);
+    }
+
+    // closes the loop made of the indices pushed since the previous loop of the last face
+    void EndLoop() {
+        auto& face = faces.back();
+        face.count = static_cast<uint32_t>(indices.size()) - face.first;
+        face.loops++;
+        loopEnds.push_back(static_cast<uint32_t>(indices.size()));
+    }
+
+    inline uint32_t Index(const Face& face, size_t k) const {
+        return indices[face.first + k];
+    }
+
+    inline const QVector3D& Point(const Face& face, size_t k) const {
+        return points[indices[face.first + k]];
+    }
+
+    // calls fn(a, b) with the vertex indices of every edge, closing each loop
+    template <class Fn>
+    void ForEachEdge(const Face& face, Fn fn) const {
+        ForEachEdgeCorners(face, [&](uint32_t ca, uint32_t cb) { fn(indices[ca], indices[cb]); });
+    }
+
+    // same walk, with the positions of the two corners in indices (and uvs)
+    template <class Fn>
+    void ForEachEdgeCorners(const Face& face, Fn fn) const {
+        uint32_t begin = face.first;
+        for (uint32_t l = 0; l < face.loops; l++) {
+            uint32_t end = loopEnds[face.loop + l];
+            for (uint32_t i = begin; i < end; i++)
+                fn(i, i + 1 < end ? i + 1 : begin);
+            begin = end;
+        }
+    }
+};
+
+#endif // MESH_H
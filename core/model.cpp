@@ -0,0 +1,107 @@
+#include "model.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+size_t Model::VertexCount() const {
+    return positions.size() / 3;
+}
+
+// ==================================================================================================
+size_t Model::FaceCount() const {
+    return faces.empty() ? 0 : faces.size() - 1;
+}
+
+// ==================================================================================================
+void Model::Prepare() {
+    auto vertexCount = VertexCount();
+    auto faceCount = FaceCount();
+    normals.assign(3 * vertexCount, 0.0f);
+    convex.assign(faceCount, 0);
+
+    auto p = [this](uint32_t v, int axis) { return static_cast<double>(positions[3 * v + axis]); };
+    for (size_t f = 0; f < faceCount; f++) {
+        auto begin = faces[f];
+        auto n = faces[f + 1] - begin;
+        if (n < 3) { continue; }
+
+        // Newell's normal, its length is twice the area of the face
+        double nx = 0, ny = 0, nz = 0;
+        for (uint32_t k = 0; k < n; k++) {
+            auto a = indices[begin + k];
+            auto b = indices[begin + (k + 1) % n];
+            nx += (p(a, 1) - p(b, 1)) * (p(a, 2) + p(b, 2));
+            ny += (p(a, 2) - p(b, 2)) * (p(a, 0) + p(b, 0));
+            nz += (p(a, 0) - p(b, 0)) * (p(a, 1) + p(b, 1));
+        }
+        for (uint32_t k = 0; k < n; k++) {
+            auto v = indices[begin + k];
+            normals[3 * v] += static_cast<float>(nx);
+            normals[3 * v + 1] += static_cast<float>(ny);
+            normals[3 * v + 2] += static_cast<float>(nz);
+        }
+
+        // convex when every corner turns the same way around the normal
+        bool turns = true;
+        for (uint32_t k = 0; k < n && turns && n > 3; k++) {
+            auto a = indices[begin + k];
+            auto b = indices[begin + (k + 1) % n];
+            auto c = indices[begin + (k + 2) % n];
+            double ux = p(b, 0) - p(a, 0), uy = p(b, 1) - p(a, 1), uz = p(b, 2) - p(a, 2);
+            double vx = p(c, 0) - p(b, 0), vy = p(c, 1) - p(b, 1), vz = p(c, 2) - p(b, 2);
+            turns = (uy * vz - uz * vy) * nx + (uz * vx - ux * vz) * ny + (ux * vy - uy * vx) * nz >= 0;
+        }
+        convex[f] = turns;
+    }
+
+    for (size_t v = 0; v < vertexCount; v++) {
+        auto n = &normals[3 * v];
+        auto length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length > 0) {
+            n[0] /= length;
+            n[1] /= length;
+            n[2] /= length;
+        }
+    }
+
+    for (int axis = 0; axis < 3; axis++) {
+        bounds[axis] = vertexCount > 0 ? positions[axis] : 0;
+        bounds[axis + 3] = bounds[axis];
+    }
+    for (size_t v = 0; v < vertexCount; v++)
+        for (int axis = 0; axis < 3; axis++) {
+            bounds[axis] = std::min(bounds[axis], positions[3 * v + axis]);
+            bounds[axis + 3] = std::max(bounds[axis + 3], positions[3 * v + axis]);
+        }
+}
+
+// ==================================================================================================
+const float* Model::Normals() const {
+    return normals.data();
+}
+
+// ==================================================================================================
+bool Model::Convex(size_t face) const {
+    return convex[face] != 0;
+}
+
+// ==================================================================================================
+const float* Model::Bounds() const {
+    return bounds;
+}
+
+// ==================================================================================================
+void Model::FitTo(int width, int height) {
+    auto extent = std::max(std::max(bounds[3] - bounds[0], bounds[4] - bounds[1]), bounds[5] - bounds[2]);
+    auto scale = extent > 0 ? 0.8f * std::min(width, height) / extent : 1.0f;
+
+    // the screen has y down and depth going away, a half turn about x keeps the model upright
+    // and facing the camera without mirroring it
+    transform.setToIdentity();
+    transform.translate(width / 2.0f, height / 2.0f, 0);
+    transform.scale(scale, -scale, -scale);
+    transform.translate(-(bounds[0] + bounds[3]) / 2, -(bounds[1] + bounds[4]) / 2, -(bounds[2] + bounds[5]) / 2);
+}
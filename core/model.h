@@ -0,0 +1,45 @@
+#ifndef MODEL_H
+#define MODEL_H
+
+#include <QColor>
+#include <QMatrix4x4>
+#include <vector>
+#include <cstdint>
+
+// A polygon mesh loaded from a file (see ModelIO) and drawn as it is, next to the extruded
+// polygons of a Scene. Vertices are x,y,z floats; faces are loops of vertex indices split by an
+// offset table (face f spans indices [faces[f], faces[f+1]) ), counterclockwise seen from
+// outside as in OBJ and PLY. Vertex normals and the convexity of every face are computed once,
+// by Prepare, when the model is loaded.
+class Model
+{
+public:
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    std::vector<uint32_t> faces;        // FaceCount() + 1 offsets into indices, the first one 0
+
+    QColor color = QColor(200, 200, 200);
+    QMatrix4x4 transform;               // model transform applied before the camera
+
+private:
+    std::vector<float> normals;         // x,y,z of every vertex, area weighted
+    std::vector<uint8_t> convex;        // of every face
+    float bounds[6] = {0, 0, 0, 0, 0, 0};   // minX, minY, minZ, maxX, maxY, maxZ
+
+public:
+    size_t VertexCount() const;
+    size_t FaceCount() const;
+
+    // computes the normals, the convex faces and the bounds once the arrays are filled
+    void Prepare();
+
+    const float* Normals() const;
+    bool Convex(size_t face) const;
+    const float* Bounds() const;
+
+    // centers the model in a width x height frame, its largest side across 80% of it, y up as
+    // in the file
+    void FitTo(int width, int height);
+};
+
+#endif // MODEL_H
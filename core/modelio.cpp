@@ -0,0 +1,556 @@
+#include "modelio.h"
+
+#include <QFile>
+#include <QtEndian>
+#include <algorithm>
+#include <thread>
+#include <cstring>
+#include <cmath>
+
+// ==================================================================================================
+static bool fail(QString* error, const QString& message) {
+    if (error != nullptr) { *error = message; }
+    return false;
+}
+
+static inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// ==================================================================================================
+// Numbers. std::from_chars would do, but it is C++17; these read the plain decimal forms the
+// exporters write, in place and without the locale or the allocation of QByteArray::toFloat.
+
+static const double POWERS[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static bool parseFloat(const char*& p, const char* end, float& value) {
+    auto s = p;
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+')) { negative = *s++ == '-'; }
+
+    // up to 19 significant digits in the mantissa, the rest only move the exponent
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+    for (; s < end && isDigit(*s); s++) {
+        any = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*s - '0');
+            digits += mantissa != 0;
+        }
+        else { exponent++; }
+    }
+    if (s < end && *s == '.') {
+        for (s++; s < end && isDigit(*s); s++) {
+            any = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*s - '0');
+                digits += mantissa != 0;
+                exponent--;
+            }
+        }
+    }
+    if (!any) { return false; }
+
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        auto e = s + 1;
+        bool negativeExponent = false;
+        if (e < end && (*e == '-' || *e == '+')) { negativeExponent = *e++ == '-'; }
+        if (e < end && isDigit(*e)) {
+            int x = 0;
+            for (; e < end && isDigit(*e); e++)
+                x = std::min(x * 10 + (*e - '0'), 9999);
+            exponent += negativeExponent ? -x : x;
+            s = e;
+        }
+    }
+
+    auto v = static_cast<double>(mantissa);
+    if (mantissa != 0 && exponent != 0) {
+        if (exponent > 0)
+            v = exponent <= 22 ? v * POWERS[exponent] : v * std::pow(10.0, exponent);
+        else
+            v = exponent >= -22 ? v / POWERS[-exponent] : v * std::pow(10.0, exponent);
+    }
+    value = static_cast<float>(negative ? -v : v);
+    p = s;
+    return true;
+}
+
+static bool parseInt(const char*& p, const char* end, int64_t& value) {
+    auto s = p;
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+')) { negative = *s++ == '-'; }
+    if (s == end || !isDigit(*s)) { return false; }
+
+    int64_t v = 0;
+    for (; s < end && isDigit(*s); s++) {
+        if (v > (INT64_C(1) << 40)) { return false; }
+        v = v * 10 + (*s - '0');
+    }
+    value = negative ? -v : v;
+    p = s;
+    return true;
+}
+
+// ==================================================================================================
+// OBJ. Every chunk is parsed on its own thread into its own arrays; relative indices can point
+// into earlier chunks, so they are resolved once the vertex count of every chunk is known.
+
+struct ObjChunk {
+    const char* begin;
+    const char* end;
+
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    std::vector<uint32_t> faceEnds;                     // end of every face in indices
+    std::vector<std::pair<size_t, int64_t>> relative;   // index slot, vertex from the chunk's first
+
+    const char* error = nullptr;                        // where parsing stopped
+    QString message;
+};
+
+static void parseObj(ObjChunk* chunk) {
+    auto p = chunk->begin;
+    auto end = chunk->end;
+    auto stop = [chunk](const char* at, const char* message) {
+        chunk->error = at;
+        chunk->message = message;
+    };
+
+    while (p < end) {
+        while (p < end && isBlank(*p)) { p++; }
+        auto line = p;
+        auto eol = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (eol == nullptr) { eol = end; }
+
+        if (eol - p > 1 && p[0] == 'v' && isBlank(p[1])) {
+            p += 2;
+            for (int k = 0; k < 3; k++) {
+                while (p < eol && isBlank(*p)) { p++; }
+                float x;
+                if (!parseFloat(p, eol, x))
+                    return stop(line, "bad vertex");
+                chunk->positions.push_back(x);
+            }
+        }
+        else if (eol - p > 1 && p[0] == 'f' && isBlank(p[1])) {
+            p += 2;
+            size_t corners = 0;
+            for (;;) {
+                while (p < eol && isBlank(*p)) { p++; }
+                if (p == eol) { break; }
+
+                int64_t i;
+                if (!parseInt(p, eol, i) || i == 0)
+                    return stop(line, "bad face");
+                if (i > 0) {
+                    if (i > UINT32_MAX)
+                        return stop(line, "vertex index out of range");
+                    chunk->indices.push_back(static_cast<uint32_t>(i - 1));
+                }
+                else {
+                    chunk->relative.emplace_back(chunk->indices.size(), static_cast<int64_t>(chunk->positions.size() / 3) + i);
+                    chunk->indices.push_back(0);
+                }
+                corners++;
+
+                // texture and normal indices
+                while (p < eol && !isBlank(*p)) { p++; }
+            }
+            if (corners < 3)
+                return stop(line, "face with fewer than three vertices");
+            chunk->faceEnds.push_back(static_cast<uint32_t>(chunk->indices.size()));
+        }
+        p = eol < end ? eol + 1 : end;
+    }
+}
+
+// ==================================================================================================
+// PLY
+
+enum PlyType { PLY_NONE, PLY_INT8, PLY_UINT8, PLY_INT16, PLY_UINT16, PLY_INT32, PLY_UINT32, PLY_FLOAT32, PLY_FLOAT64 };
+
+struct PlyProperty {
+    PlyType type;
+    PlyType countType;      // PLY_NONE unless a list
+    QByteArray name;
+};
+
+struct PlyElement {
+    QByteArray name;
+    uint64_t count;
+    std::vector<PlyProperty> properties;
+};
+
+static PlyType plyType(const QByteArray& name) {
+    if (name == "char" || name == "int8") { return PLY_INT8; }
+    if (name == "uchar" || name == "uint8") { return PLY_UINT8; }
+    if (name == "short" || name == "int16") { return PLY_INT16; }
+    if (name == "ushort" || name == "uint16") { return PLY_UINT16; }
+    if (name == "int" || name == "int32") { return PLY_INT32; }
+    if (name == "uint" || name == "uint32") { return PLY_UINT32; }
+    if (name == "float" || name == "float32") { return PLY_FLOAT32; }
+    if (name == "double" || name == "float64") { return PLY_FLOAT64; }
+    return PLY_NONE;
+}
+
+static size_t plySize(PlyType type) {
+    static const size_t SIZES[] = {0, 1, 1, 2, 2, 4, 4, 4, 8};
+    return SIZES[type];
+}
+
+template <class T>
+static inline T plyLoad(const uchar* p, bool bigEndian) {
+    return bigEndian ? qFromBigEndian<T>(p) : qFromLittleEndian<T>(p);
+}
+
+static double plyValue(PlyType type, const uchar* p, bool bigEndian) {
+    switch (type) {
+        case PLY_INT8: return static_cast<int8_t>(*p);
+        case PLY_UINT8: return *p;
+        case PLY_INT16: return static_cast<int16_t>(plyLoad<uint16_t>(p, bigEndian));
+        case PLY_UINT16: return plyLoad<uint16_t>(p, bigEndian);
+        case PLY_INT32: return static_cast<int32_t>(plyLoad<uint32_t>(p, bigEndian));
+        case PLY_UINT32: return plyLoad<uint32_t>(p, bigEndian);
+        case PLY_FLOAT32: {
+            auto bits = plyLoad<uint32_t>(p, bigEndian);
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            return f;
+        }
+        case PLY_FLOAT64: {
+            auto bits = plyLoad<uint64_t>(p, bigEndian);
+            double d;
+            memcpy(&d, &bits, sizeof(d));
+            return d;
+        }
+        default: return 0;
+    }
+}
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+bool ModelIO::Load(const QString& path, Model& model, QString* error) {
+    return path.endsWith(".ply", Qt::CaseInsensitive) ? LoadPly(path, model, error) : LoadObj(path, model, error);
+}
+
+// ==================================================================================================
+bool ModelIO::LoadObj(const QString& path, Model& model, QString* error) {
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+        return fail(error, file.errorString());
+    if (file.size() == 0)
+        return fail(error, "no faces in model file");
+
+    auto size = static_cast<size_t>(file.size());
+    auto data = reinterpret_cast<const char*>(file.map(0, file.size()));
+    if (data == nullptr)
+        return fail(error, file.errorString());
+
+    // a chunk per core, but none under 4 MB; chunks start after a line break
+    auto cores = static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u));
+    auto workers = std::max<size_t>(std::min(cores, size >> 22), 1);
+    std::vector<ObjChunk> chunks(workers);
+    auto begin = data;
+    for (size_t w = 0; w < workers; w++) {
+        auto end = data + size;
+        if (w + 1 < workers) {
+            end = std::max(begin, data + size / workers * (w + 1));
+            auto eol = static_cast<const char*>(memchr(end, '\n', static_cast<size_t>(data + size - end)));
+            end = eol != nullptr ? eol + 1 : data + size;
+        }
+        chunks[w].begin = begin;
+        chunks[w].end = end;
+        begin = end;
+    }
+
+    std::vector<std::thread> pool;
+    for (size_t w = 1; w < workers; w++)
+        pool.emplace_back(parseObj, &chunks[w]);
+    parseObj(&chunks[0]);
+    for (auto& thread : pool)
+        thread.join();
+
+    for (auto& chunk : chunks)
+        if (chunk.error != nullptr) {
+            auto line = static_cast<qlonglong>(std::count(data, chunk.error, '\n')) + 1;
+            return fail(error, QString("%1 at line %2").arg(chunk.message).arg(line));
+        }
+
+    // concatenated, the first chunk's arrays are taken over
+    size_t vertexCount = 0, indexCount = 0, faceCount = 0;
+    for (auto& chunk : chunks) {
+        vertexCount += chunk.positions.size() / 3;
+        indexCount += chunk.indices.size();
+        faceCount += chunk.faceEnds.size();
+    }
+    if (faceCount == 0)
+        return fail(error, "no faces in model file");
+    if (vertexCount > UINT32_MAX || indexCount > UINT32_MAX)
+        return fail(error, "model too large");
+
+    model.positions = std::move(chunks[0].positions);
+    model.indices = std::move(chunks[0].indices);
+    model.positions.reserve(3 * vertexCount);
+    model.indices.reserve(indexCount);
+    model.faces.clear();
+    model.faces.reserve(faceCount + 1);
+    model.faces.push_back(0);
+
+    for (size_t w = 0; w < workers; w++) {
+        auto& chunk = chunks[w];
+        auto vertexBase = static_cast<int64_t>(w > 0 ? model.positions.size() / 3 : 0);
+        auto indexBase = w > 0 ? model.indices.size() : 0;
+        if (w > 0) {
+            model.positions.insert(model.positions.end(), chunk.positions.begin(), chunk.positions.end());
+            model.indices.insert(model.indices.end(), chunk.indices.begin(), chunk.indices.end());
+        }
+        for (auto& r : chunk.relative) {
+            auto v = vertexBase + r.second;
+            if (v < 0)
+                return fail(error, "vertex index out of range");
+            model.indices[indexBase + r.first] = static_cast<uint32_t>(v);
+        }
+        for (auto e : chunk.faceEnds)
+            model.faces.push_back(static_cast<uint32_t>(indexBase + e));
+
+        chunk = ObjChunk();
+    }
+
+    for (auto i : model.indices)
+        if (i >= vertexCount)
+            return fail(error, "vertex index out of range");
+
+    model.Prepare();
+    return true;
+}
+
+// ==================================================================================================
+bool ModelIO::LoadPly(const QString& path, Model& model, QString* error) {
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+        return fail(error, file.errorString());
+    if (file.size() == 0)
+        return fail(error, "not a PLY file");
+
+    auto size = static_cast<size_t>(file.size());
+    auto data = file.map(0, file.size());
+    if (data == nullptr)
+        return fail(error, file.errorString());
+    auto end = data + size;
+
+    // header, one record per line up to end_header
+    auto p = reinterpret_cast<const char*>(data);
+    bool bigEndian = false;
+    bool formatSeen = false;
+    std::vector<PlyElement> elements;
+    for (bool first = true; ; first = false) {
+        auto eol = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(reinterpret_cast<const char*>(end) - p)));
+        if (eol == nullptr)
+            return fail(error, first ? "not a PLY file" : "truncated PLY header");
+        auto fields = QByteArray(p, static_cast<int>(eol - p)).simplified().split(' ');
+        p = eol + 1;
+
+        auto& keyword = fields[0];
+        if (first) {
+            if (keyword != "ply" || fields.size() != 1)
+                return fail(error, "not a PLY file");
+        }
+        else if (keyword == "format") {
+            if (fields.size() < 2 || fields[1] == "ascii")
+                return fail(error, "only binary PLY files are supported");
+            if (fields[1] != "binary_little_endian" && fields[1] != "binary_big_endian")
+                return fail(error, "unknown PLY format");
+            bigEndian = fields[1] == "binary_big_endian";
+            formatSeen = true;
+        }
+        else if (keyword == "element") {
+            bool ok = fields.size() == 3;
+            auto count = ok ? fields[2].toULongLong(&ok) : 0;
+            if (!ok)
+                return fail(error, "bad PLY element");
+            elements.push_back({fields[1], count, {}});
+        }
+        else if (keyword == "property") {
+            if (elements.empty())
+                return fail(error, "PLY property outside an element");
+            PlyProperty property = {PLY_NONE, PLY_NONE, QByteArray()};
+            if (fields.size() == 5 && fields[1] == "list") {
+                property.countType = plyType(fields[2]);
+                property.type = plyType(fields[3]);
+                property.name = fields[4];
+                if (property.countType == PLY_NONE || property.countType == PLY_FLOAT32
+                        || property.countType == PLY_FLOAT64)
+                    property.type = PLY_NONE;
+            }
+            else if (fields.size() == 3) {
+                property.type = plyType(fields[1]);
+                property.name = fields[2];
+            }
+            if (property.type == PLY_NONE)
+                return fail(error, "bad PLY property");
+            elements.back().properties.push_back(property);
+        }
+        else if (keyword == "end_header") {
+            break;
+        }
+        // comment, obj_info and anything unknown are skipped
+    }
+    if (!formatSeen)
+        return fail(error, "not a PLY file");
+
+    auto cursor = reinterpret_cast<const uchar*>(p);
+    auto truncated = [&]() { return fail(error, "truncated PLY file"); };
+
+    model.positions.clear();
+    model.indices.clear();
+    model.faces.assign(1, 0);
+    bool vertices = false;
+    double vertexLimit = UINT32_MAX;
+
+    for (auto& element : elements) {
+        bool fixed = true;
+        size_t stride = 0;
+        for (auto& property : element.properties) {
+            fixed = fixed && property.countType == PLY_NONE;
+            stride += plySize(property.type);
+        }
+
+        if (element.name == "vertex" && fixed) {
+            // fixed records, read through the offsets of x, y and z
+            int axes[3] = {-1, -1, -1};
+            for (size_t k = 0; k < element.properties.size(); k++) {
+                auto& name = element.properties[k].name;
+                if (name == "x") { axes[0] = static_cast<int>(k); }
+                if (name == "y") { axes[1] = static_cast<int>(k); }
+                if (name == "z") { axes[2] = static_cast<int>(k); }
+            }
+            if (axes[0] < 0 || axes[1] < 0 || axes[2] < 0)
+                return fail(error, "PLY vertices without x, y and z");
+            if (element.count > UINT32_MAX)
+                return fail(error, "model too large");
+            if (stride == 0 || element.count > static_cast<uint64_t>(end - cursor) / stride)
+                return truncated();
+
+            size_t offsets[3];
+            PlyType types[3];
+            for (int axis = 0; axis < 3; axis++) {
+                offsets[axis] = 0;
+                for (int k = 0; k < axes[axis]; k++)
+                    offsets[axis] += plySize(element.properties[k].type);
+                types[axis] = element.properties[axes[axis]].type;
+            }
+
+            auto count = static_cast<size_t>(element.count);
+            model.positions.resize(3 * count);
+            for (size_t v = 0; v < count; v++, cursor += stride)
+                for (int axis = 0; axis < 3; axis++)
+                    model.positions[3 * v + axis] = static_cast<float>(plyValue(types[axis], cursor + offsets[axis], bigEndian));
+            vertexLimit = static_cast<double>(count);
+            vertices = true;
+        }
+        else if (element.name == "vertex") {
+            return fail(error, "PLY vertices with list properties");
+        }
+        else if (element.name == "face") {
+            if (element.count > UINT32_MAX)
+                return fail(error, "model too large");
+
+            // the smallest record a face can have bounds the count by the bytes left, before the
+            // header gets to reserve for it
+            size_t record = 0;
+            for (auto& property : element.properties) {
+                auto itemSize = plySize(property.type);
+                bool indices = property.name == "vertex_indices" || property.name == "vertex_index";
+                record += property.countType == PLY_NONE ? itemSize
+                        : plySize(property.countType) + (indices ? 3 * itemSize : 0);
+            }
+            if (record > 0 && element.count > static_cast<uint64_t>(end - cursor) / record)
+                return truncated();
+            model.faces.reserve(static_cast<size_t>(element.count) + 1);
+            model.indices.reserve(3 * static_cast<size_t>(element.count));
+
+            bool found = false;
+            for (uint64_t f = 0; f < element.count; f++)
+                for (auto& property : element.properties) {
+                    auto itemSize = plySize(property.type);
+                    if (property.countType == PLY_NONE) {
+                        if (itemSize > static_cast<size_t>(end - cursor)) { return truncated(); }
+                        cursor += itemSize;
+                        continue;
+                    }
+
+                    auto countSize = plySize(property.countType);
+                    if (countSize > static_cast<size_t>(end - cursor)) { return truncated(); }
+                    auto n = static_cast<size_t>(plyValue(property.countType, cursor, bigEndian));
+                    cursor += countSize;
+                    if (n > static_cast<size_t>(end - cursor) / itemSize) { return truncated(); }
+
+                    if (property.name != "vertex_indices" && property.name != "vertex_index") {
+                        cursor += n * itemSize;
+                        continue;
+                    }
+                    if (n < 3)
+                        return fail(error, "face with fewer than three vertices");
+                    for (size_t k = 0; k < n; k++, cursor += itemSize) {
+                        auto i = plyValue(property.type, cursor, bigEndian);
+                        if (i < 0 || i >= vertexLimit)
+                            return fail(error, "vertex index out of range");
+                        model.indices.push_back(static_cast<uint32_t>(i));
+                    }
+                    if (model.indices.size() > UINT32_MAX)
+                        return fail(error, "model too large");
+                    model.faces.push_back(static_cast<uint32_t>(model.indices.size()));
+                    found = true;
+                }
+            if (!found && element.count > 0)
+                return fail(error, "PLY faces without vertex_indices");
+        }
+        else if (fixed) {
+            if (stride > 0 && element.count > static_cast<uint64_t>(end - cursor) / stride)
+                return truncated();
+            cursor += static_cast<size_t>(element.count) * stride;
+        }
+        else {
+            for (uint64_t r = 0; r < element.count; r++)
+                for (auto& property : element.properties) {
+                    auto n = size_t(1);
+                    if (property.countType != PLY_NONE) {
+                        auto countSize = plySize(property.countType);
+                        if (countSize > static_cast<size_t>(end - cursor)) { return truncated(); }
+                        n = static_cast<size_t>(plyValue(property.countType, cursor, bigEndian));
+                        cursor += countSize;
+                    }
+                    if (n > static_cast<size_t>(end - cursor) / plySize(property.type)) { return truncated(); }
+                    cursor += n * plySize(property.type);
+                }
+        }
+    }
+
+    if (!vertices)
+        return fail(error, "PLY file without vertices");
+    if (model.FaceCount() == 0)
+        return fail(error, "no faces in model file");
+    auto vertexCount = model.VertexCount();
+    for (auto i : model.indices)
+        if (i >= vertexCount)
+            return fail(error, "vertex index out of range");
+
+    model.Prepare();
+    return true;
+}
+
+// ==================================================================================================
+bool ModelIO::IsModel(const QString& path) {
+    return path.endsWith(".obj", Qt::CaseInsensitive) || path.endsWith(".ply", Qt::CaseInsensitive);
+}
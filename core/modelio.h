@@ -0,0 +1,35 @@
+#ifndef MODELIO_H
+#define MODELIO_H
+
+#include <QString>
+#include "model.h"
+
+// Mesh files, read straight into the indexed layout of Model.
+//
+// Wavefront OBJ (".obj"), text. Only geometry is read:
+//   v x y z [w]                        a vertex, w ignored
+//   f a b c ...                        a face, 1-based vertex indices, negative ones relative to
+//                                      the last vertex; a/t/n and a//n take the vertex index only
+// every other record (vt, vn, o, g, s, usemtl, comments, ...) is skipped. Large files are split
+// at line breaks and the pieces parsed on every core, then concatenated.
+//
+// Stanford PLY (".ply"), binary_little_endian or binary_big_endian 1.0:
+//   element vertex N with float or integer properties x, y and z
+//   element face M with a list property vertex_indices (or vertex_index)
+// other elements and properties are skipped. ASCII PLY is refused.
+//
+// Both are memory mapped, and numbers are parsed in place without the locale.
+class ModelIO
+{
+public:
+    // picks the format from the extension
+    static bool Load(const QString& path, Model& model, QString* error = nullptr);
+
+    static bool LoadObj(const QString& path, Model& model, QString* error = nullptr);
+    static bool LoadPly(const QString& path, Model& model, QString* error = nullptr);
+
+    // whether path names a mesh rather than a scene
+    static bool IsModel(const QString& path);
+};
+
+#endif // MODELIO_H
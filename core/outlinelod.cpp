@@ -0,0 +1,151 @@
+#include "outlinelod.h"
+
+#include <algorithm>
+#include <queue>
+#include <limits>
+#include <cmath>
+
+// ==================================================================================================
+static float triangleArea(const float* coords, uint32_t a, uint32_t b, uint32_t c) {
+    double abx = static_cast<double>(coords[2*b]) - coords[2*a];
+    double aby = static_cast<double>(coords[2*b+1]) - coords[2*a+1];
+    double acx = static_cast<double>(coords[2*c]) - coords[2*a];
+    double acy = static_cast<double>(coords[2*c+1]) - coords[2*a+1];
+    return static_cast<float>(std::abs(abx * acy - aby * acx) / 2);
+}
+
+// ==================================================================================================
+// every turn goes the same way and the outline winds once: x changes direction at most twice
+static bool isConvex(const float* coords, uint32_t begin, uint32_t end) {
+    auto n = end - begin;
+    if (n < 3) { return false; }
+
+    int turn = 0;
+    int firstDir = 0, lastDir = 0, flips = 0;
+    for (uint32_t k = 0; k < n; k++) {
+        auto a = begin + k;
+        auto b = begin + (k + 1) % n;
+        auto c = begin + (k + 2) % n;
+        double abx = static_cast<double>(coords[2*b]) - coords[2*a];
+        double aby = static_cast<double>(coords[2*b+1]) - coords[2*a+1];
+        double bcx = static_cast<double>(coords[2*c]) - coords[2*b];
+        double bcy = static_cast<double>(coords[2*c+1]) - coords[2*b+1];
+
+        auto cross = abx * bcy - aby * bcx;
+        if (cross != 0) {
+            auto t = cross > 0 ? 1 : -1;
+            if (turn != 0 && t != turn) { return false; }
+            turn = t;
+        }
+
+        if (abx != 0) {
+            auto dir = abx > 0 ? 1 : -1;
+            if (firstDir == 0) { firstDir = dir; }
+            if (lastDir != 0 && dir != lastDir) { flips++; }
+            lastDir = dir;
+        }
+    }
+    if (lastDir != firstDir) { flips++; }
+    return turn != 0 && flips <= 2;
+}
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+void OutlineLod::Build(const float* coords, const uint32_t* contours, size_t contourCount) {
+    auto vertexCount = contourCount > 0 ? contours[contourCount] : 0;
+    ranks.assign(vertexCount, std::numeric_limits<float>::max());
+    bounds.resize(4 * contourCount);
+    convex.resize(contourCount);
+    prev.resize(vertexCount);
+    next.resize(vertexCount);
+
+    // (area, vertex) of the candidates, stale entries are skipped when their area is outdated
+    typedef std::pair<float, uint32_t> Candidate;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> heap;
+    std::vector<float> area(vertexCount);
+
+    for (size_t c = 0; c < contourCount; c++) {
+        auto begin = contours[c];
+        auto end = contours[c+1];
+
+        auto box = &bounds[4*c];
+        box[0] = box[2] = begin < end ? coords[2*begin] : 0;
+        box[1] = box[3] = begin < end ? coords[2*begin+1] : 0;
+        for (auto i = begin; i < end; i++) {
+            box[0] = std::min(box[0], coords[2*i]);
+            box[1] = std::min(box[1], coords[2*i+1]);
+            box[2] = std::max(box[2], coords[2*i]);
+            box[3] = std::max(box[3], coords[2*i+1]);
+        }
+        convex[c] = isConvex(coords, begin, end);
+        if (end - begin <= 3) { continue; }
+
+        for (auto i = begin; i < end; i++) {
+            prev[i] = i > begin ? i - 1 : end - 1;
+            next[i] = i + 1 < end ? i + 1 : begin;
+        }
+        for (auto i = begin; i < end; i++) {
+            area[i] = triangleArea(coords, prev[i], i, next[i]);
+            heap.push({area[i], i});
+        }
+
+        // removes the smallest triangle until 3 vertices are left, a vertex never ranks below
+        // the ones removed before it so every threshold cuts the removal order in one place
+        auto left = end - begin;
+        float removed = 0;
+        while (left > 3) {
+            auto top = heap.top();
+            heap.pop();
+            auto i = top.second;
+            if (ranks[i] != std::numeric_limits<float>::max() || top.first != area[i]) { continue; }
+
+            removed = std::max(removed, top.first);
+            ranks[i] = removed;
+            left--;
+
+            auto p = prev[i], n = next[i];
+            next[p] = n;
+            prev[n] = p;
+            area[p] = triangleArea(coords, prev[p], p, n);
+            area[n] = triangleArea(coords, p, n, next[n]);
+            heap.push({area[p], p});
+            heap.push({area[n], n});
+        }
+        heap = decltype(heap)();
+    }
+}
+
+// ==================================================================================================
+void OutlineLod::Clear() {
+    ranks.clear();
+    bounds.clear();
+    convex.clear();
+}
+
+// ==================================================================================================
+const float* OutlineLod::Bounds(size_t contour) const {
+    return &bounds[4*contour];
+}
+
+// ==================================================================================================
+bool OutlineLod::Convex(size_t contour) const {
+    return convex[contour] != 0;
+}
+
+// ==================================================================================================
+size_t OutlineLod::Select(const float* coords, const uint32_t* contours, size_t first, size_t count,
+                          float minArea, std::vector<float>& outCoords, std::vector<uint32_t>& outContours) const {
+    outCoords.clear();
+    outContours.assign(1, 0);
+
+    for (size_t c = first; c < first + count; c++) {
+        for (auto i = contours[c]; i < contours[c+1]; i++)
+            if (ranks[i] >= minArea) {
+                outCoords.push_back(coords[2*i]);
+                outCoords.push_back(coords[2*i+1]);
+            }
+        outContours.push_back(static_cast<uint32_t>(outCoords.size() / 2));
+    }
+    return outCoords.size() / 2;
+}
@@ -0,0 +1,39 @@
+#ifndef OUTLINELOD_H
+#define OUTLINELOD_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Simplification hierarchy of a set of contours, laid out as in Scene (an x,y float array split
+// by an offset table). Visvalingam-Whyatt ranks every vertex by the area of the triangle it makes
+// with its neighbours when it is removed, forced monotone along the removal order, so keeping the
+// vertices whose rank reaches a threshold is exactly one level of the hierarchy. Building costs
+// O(n log n) once per edit, picking a level is one pass over the ranks.
+class OutlineLod
+{
+private:
+    std::vector<float> ranks;       // effective area of every vertex, in source units squared
+    std::vector<float> bounds;      // minX, minY, maxX, maxY of every contour
+    std::vector<uint8_t> convex;    // of every contour, so of every level of it
+
+    // scratch of Build
+    std::vector<uint32_t> prev, next;
+
+public:
+    // ranks the contours, the last 3 vertices of each one are always kept
+    void Build(const float* coords, const uint32_t* contours, size_t contourCount);
+    void Clear();
+
+    const float* Bounds(size_t contour) const;
+
+    // the contour is convex, and so is any subset of its vertices Select keeps
+    bool Convex(size_t contour) const;
+
+    // the vertices of contours first..first+count whose rank is at least minArea, laid out in
+    // coords (cleared first) with count + 1 offsets in contours; returns the vertices kept
+    size_t Select(const float* coords, const uint32_t* contours, size_t first, size_t count,
+                  float minArea, std::vector<float>& outCoords, std::vector<uint32_t>& outContours) const;
+};
+
+#endif // OUTLINELOD_H
@@ -0,0 +1,53 @@
+#include "overdrawcounters.h"
+
+#include <algorithm>
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+void OverdrawCounters::Reset(int width, int height) {
+    this->width = width;
+    this->height = height;
+    for (auto& c : counts)
+        c.assign(static_cast<size_t>(width) * static_cast<size_t>(height), 0);
+    failed = 0;
+}
+
+// ==================================================================================================
+void OverdrawCounters::Sum(RenderStats& stats) const {
+    for (auto n : counts[WRITES]) {
+        stats.writes += n;
+        stats.covered += n > 0 ? 1 : 0;
+    }
+    for (auto n : counts[SHADES])
+        stats.shades += n;
+
+    stats.depthFailed = failed;
+    size_t tests = 0;
+    for (auto n : counts[TESTS])
+        tests += n;
+    stats.depthPassed = tests - failed;
+}
+
+// ==================================================================================================
+void OverdrawCounters::Paint(Counter counter, QImage& image) const {
+    static const QRgb RAMP[] = {
+        qRgba(0, 0, 0, 0),
+        qRgb(0, 0, 160),
+        qRgb(0, 96, 255),
+        qRgb(0, 200, 200),
+        qRgb(0, 200, 0),
+        qRgb(230, 230, 0),
+        qRgb(255, 140, 0),
+        qRgb(230, 0, 0),
+        qRgb(255, 255, 255),
+    };
+    const uint32_t top = sizeof(RAMP) / sizeof(RAMP[0]) - 1;
+
+    auto& c = counts[counter];
+    for (int y = 0; y < std::min(height, image.height()); y++) {
+        auto row = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < std::min(width, image.width()); x++)
+            row[x] = RAMP[std::min(c[index(x, y)], top)];
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef OVERDRAWCOUNTERS_H
+#define OVERDRAWCOUNTERS_H
+
+#include <QImage>
+#include <vector>
+#include <cstdint>
+
+#include "renderstats.h"
+
+// Per pixel work of one frame, behind the heatmap debug views: depth tests, pixel writes and
+// lighting evaluations (PHONG). The fills only touch it while a heatmap is shown.
+class OverdrawCounters
+{
+public:
+    enum Counter {
+        TESTS,
+        WRITES,
+        SHADES,
+        COUNTER_COUNT
+    };
+
+private:
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> counts[COUNTER_COUNT];
+    size_t failed = 0;
+
+public:
+    void Reset(int width, int height);
+
+    inline void Test(int x, int y, bool pass) {
+        counts[TESTS][index(x, y)]++;
+        if (pass) { counts[WRITES][index(x, y)]++; }
+        else { failed++; }
+    }
+
+    // a write without a depth test (scanline and S-buffer visibility)
+    inline void Write(int x, int y) {
+        counts[WRITES][index(x, y)]++;
+    }
+
+    inline void Shade(int x, int y, uint32_t lights) {
+        counts[SHADES][index(x, y)] += lights;
+    }
+
+    // depth test outcomes, writes, covered pixels and lighting evaluations of the frame
+    void Sum(RenderStats& stats) const;
+
+    // false color ramp of a counter: blue for one, through green and yellow, to red and white
+    // at 8 and more; pixels never counted stay transparent
+    void Paint(Counter counter, QImage& image) const;
+
+private:
+    inline size_t index(int x, int y) const {
+        return static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x);
+    }
+};
+
+#endif // OVERDRAWCOUNTERS_H
@@ -0,0 +1,136 @@
+#include "pointclassifier.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <cmath>
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+void PointClassifier::SetPolygon(const float* coords, const uint32_t* contours, size_t first, size_t count) {
+    edges.clear();
+    for (auto c = first; c < first + count; c++) {
+        auto begin = contours[c];
+        auto end = contours[c + 1];
+        for (auto i = begin; i < end; i++) {
+            auto j = i + 1 < end ? i + 1 : begin;
+            double ax = coords[2 * i], ay = coords[2 * i + 1];
+            double bx = coords[2 * j], by = coords[2 * j + 1];
+            if (ay == by) { continue; }
+            if (ay > by) {
+                std::swap(ax, bx);
+                std::swap(ay, by);
+            }
+            edges.push_back({ay, by, ax, (bx - ax) / (by - ay)});
+        }
+    }
+    std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.y0 < b.y0; });
+}
+
+// ==================================================================================================
+void PointClassifier::Classify(const float* points, size_t count, std::vector<uint64_t>& inside, int threads) {
+    inside.assign((count + 63) / 64, 0);
+    if (count == 0 || edges.empty()) { return; }
+
+    // every thread sorts and sweeps its own y-range, one under ~64k points is not worth it
+    auto cores = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    auto workers = static_cast<size_t>(threads > 0 ? threads : cores);
+    workers = std::max<size_t>(std::min(workers, count / 65536), 1);
+
+    // the points are bucketed by y in one counting pass, a range per thread
+    auto minY = std::numeric_limits<float>::max();
+    auto maxY = std::numeric_limits<float>::lowest();
+    for (size_t i = 0; i < count; i++) {
+        minY = std::min(minY, points[2 * i + 1]);
+        maxY = std::max(maxY, points[2 * i + 1]);
+    }
+    auto scale = maxY > minY ? workers / (static_cast<double>(maxY) - minY) : 0.0;
+    auto bucket = [&](float y) {
+        return std::min(static_cast<size_t>((y - minY) * scale), workers - 1);
+    };
+
+    std::vector<size_t> starts(workers + 1, 0);
+    for (size_t i = 0; i < count; i++)
+        starts[bucket(points[2 * i + 1]) + 1]++;
+    for (size_t b = 0; b < workers; b++)
+        starts[b + 1] += starts[b];
+
+    keys.resize(count);
+    auto fill = starts;
+    for (size_t i = 0; i < count; i++) {
+        auto y = points[2 * i + 1];
+        keys[fill[bucket(y)]++] = {y, static_cast<uint32_t>(i)};
+    }
+    hits.assign(count, 0);
+
+    std::vector<std::thread> pool;
+    for (size_t b = 1; b < workers; b++)
+        pool.emplace_back(&PointClassifier::sweep, this, points, starts[b], starts[b + 1]);
+    sweep(points, starts[0], starts[1]);
+    for (auto& thread : pool)
+        thread.join();
+
+    for (size_t i = 0; i < count; i++)
+        inside[i >> 6] |= static_cast<uint64_t>(hits[i]) << (i & 63);
+}
+
+// ==================================================================================================
+// PRIVATE MEMBERS
+// ==================================================================================================
+void PointClassifier::sweep(const float* points, size_t begin, size_t end) {
+    std::sort(keys.begin() + static_cast<std::ptrdiff_t>(begin), keys.begin() + static_cast<std::ptrdiff_t>(end),
+              [](const Key& a, const Key& b) { return a.y < b.y; });
+
+    std::vector<const Edge*> aet;
+    size_t next = 0;
+    auto slabEnd = -std::numeric_limits<double>::infinity();
+    bool ordered = true;
+
+    for (auto k = begin; k < end; k++) {
+        auto i = keys[k].point;
+        double px = points[2 * i], py = keys[k].y;
+
+        // a new slab between two vertex heights, the AET is brought to py
+        if (py >= slabEnd) {
+            for (; next < edges.size() && edges[next].y0 <= py; next++)
+                aet.push_back(&edges[next]);
+            aet.erase(std::remove_if(aet.begin(), aet.end(), [py](const Edge* e) { return e->y1 <= py; }),
+                      aet.end());
+
+            // nearly sorted from the previous slab
+            auto before = [py](const Edge* a, const Edge* b) {
+                auto xa = a->At(py), xb = b->At(py);
+                return xa < xb || (xa == xb && a->dx < b->dx);
+            };
+            for (size_t m = 1; m < aet.size(); m++)
+                for (size_t n = m; n > 0 && before(aet[n], aet[n-1]); n--)
+                    std::swap(aet[n], aet[n-1]);
+
+            slabEnd = next < edges.size() ? edges[next].y0 : std::numeric_limits<double>::infinity();
+            for (auto e : aet)
+                slabEnd = std::min(slabEnd, e->y1);
+
+            // edges are lines, in order at both ends of the slab they are in order all through it;
+            // only a self-intersecting outline crosses inside one
+            ordered = true;
+            for (size_t m = 1; m < aet.size() && ordered; m++) {
+                auto xa = aet[m-1]->At(slabEnd), xb = aet[m]->At(slabEnd);
+                ordered = xa <= xb + 1e-9 * (1 + fabs(xb));
+            }
+        }
+
+        // crossings at or left of the point
+        size_t crossings;
+        if (ordered) {
+            crossings = static_cast<size_t>(std::partition_point(aet.begin(), aet.end(),
+                            [px, py](const Edge* e) { return e->At(py) <= px; }) - aet.begin());
+        }
+        else {
+            crossings = 0;
+            for (auto e : aet)
+                crossings += e->At(py) <= px;
+        }
+        hits[i] = crossings & 1;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef POINTCLASSIFIER_H
+#define POINTCLASSIFIER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Batch point-in-polygon. Instead of casting a ray against every edge for every point, the
+// points are sorted by y and swept once through the edge table of the polygon, as the fills do
+// with their scanlines: between two vertex heights the active edges keep their order, so a point
+// is classified by a binary search of its x among the crossings of its height (odd-even, holes
+// work). O((N + E) log E) for N points and E edges, plus the sort of the points; both are split
+// in y-ranges over threads.
+// A point exactly on an edge follows the fill rule of the rasterizer: inside on a top or left
+// edge, outside on a bottom or right one, so querying pixel centers agrees with the fills.
+class PointClassifier
+{
+private:
+    struct Edge {
+        double y0, y1;      // active for y0 <= y < y1
+        double x0, dx;
+
+        inline double At(double y) const { return x0 + (y - y0) * dx; }
+    };
+
+    // a query point, sorted by y
+    struct Key {
+        float y;
+        uint32_t point;
+    };
+
+    std::vector<Edge> edges;        // by y0
+
+    // scratch of Classify
+    std::vector<Key> keys;
+    std::vector<uint8_t> hits;
+
+public:
+    // the polygon, contours first..first+count laid out as in Scene
+    void SetPolygon(const float* coords, const uint32_t* contours, size_t first, size_t count);
+
+    // bit i of inside is set when point i (x,y pairs) is inside the polygon; threads = 0 uses
+    // every core
+    void Classify(const float* points, size_t count, std::vector<uint64_t>& inside, int threads = 0);
+
+    static inline bool Inside(const std::vector<uint64_t>& inside, size_t i) {
+        return (inside[i >> 6] >> (i & 63)) & 1;
+    }
+
+private:
+    // sorts keys begin..end-1 and classifies their points into hits
+    void sweep(const float* points, size_t begin, size_t end);
+};
+
+#endif // POINTCLASSIFIER_H
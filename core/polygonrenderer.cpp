@@ -0,0 +1,1721 @@
+#include "polygonrenderer.h"
+#include <algorithm>
+#include <iostream>
+#include <QElapsedTimer>
+
+#include "cgutils.h"
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+PolygonRenderer::PolygonRenderer(LightSet* lights, Camera* camera) :
+    lights(lights), camera(camera), shading(Shading::FLAT) {}
+
+// ==================================================================================================
+PolygonRenderer::~PolygonRenderer() {}
+
+// ==================================================================================================
+void PolygonRenderer::Render(FrameBuffer& target, QColor paintColor) {
+    QElapsedTimer timer;
+    timer.start();
+    auto heap = AllocTracker::Current();
+    AllocTracker::ResetPeak();
+
+    stats = RenderStats();
+    renderFrame(target, paintColor);
+
+    auto after = AllocTracker::Current();
+    for (int i = 0; i < AllocTracker::STAGE_COUNT; i++) {
+        stats.stageAllocations[i] = after.count[i] - heap.count[i];
+        stats.allocations += stats.stageAllocations[i];
+        stats.allocatedBytes += after.bytes[i] - heap.bytes[i];
+    }
+    stats.peakBytes = static_cast<size_t>(after.peak - heap.live);
+    stats.nsecs = timer.nsecsElapsed();
+}
+
+// ==================================================================================================
+void PolygonRenderer::renderFrame(FrameBuffer& target, QColor paintColor) {
+    target.Clear();
+    counters = heatmap != Heatmap::NONE ? &overdraw : nullptr;
+    if (counters != nullptr)
+        counters->Reset(target.Width(), target.Height());
+
+    // every polygon goes through the same geometry stage and shares the depth buffer
+    {
+        AllocTracker::Scope scope(AllocTracker::GEOMETRY);
+        preparePoints(mesh, paintColor, target.Width(), target.Height());
+    }
+    if (mesh.faces.empty()) { return; }
+
+    AllocTracker::Scope scope(AllocTracker::FILL);
+
+    bool textured = texture != nullptr;
+    bool scanlineOnly = visibility == Visibility::SCANLINE && shading == Shading::FLAT && !antiAliasing && !textured;
+    bool sbuffer = visibility == Visibility::SBUFFER && shading != Shading::PHONG && !antiAliasing && !textured;
+    spanBuffered = sbuffer;
+
+    // translucent faces are recorded as the opaque ones are filled and blended once they all are
+    bool blend = false;
+    if (!scanlineOnly && !sbuffer)
+        for (auto& face : mesh.faces)
+            blend = blend || (face.count >= 3 && isTranslucent(face));
+    if (blend)
+        aBuffer.Reset(target.Height());
+
+    // PHONG lights translucent faces per vertex, their fragments are blended from colors
+    if (shading == Shading::GOURAUD || (shading == Shading::PHONG && blend))
+        lightVertices(mesh);
+
+    if (scanlineOnly) {
+        scanlineFill(mesh, target);
+        showHeatmap(target);
+        stats.faces = mesh.faces.size() - stats.culled;
+        return;
+    }
+
+    if (sbuffer) {
+        spanBuffer.Reset(target.Height(), camera->isPerspective);
+        faceColors.resize(mesh.faces.size());
+    }
+
+    for (auto& face : mesh.faces)
+        if (face.count < 3)
+            continue;   // rejected or clipped away
+        else if (blend && isTranslucent(face))
+            translucentFill(mesh, face, target);
+        else if (antiAliasing)
+            antiAliasedFill(mesh, face, target);
+        else if (face.texture != nullptr)
+            oddEvenFillMethodTEXTURE(mesh, face, target);
+        else switch (shading) {
+        case Shading::FLAT :
+            oddEvenFillMethodFLAT(mesh, face, target);
+            break;
+        case Shading::GOURAUD :
+            oddEvenFillMethodGOURAULD(mesh, face, target);
+            break;
+        case Shading::PHONG:
+            oddEvenFillMethodPHONG(mesh, face, target);
+        }
+
+    if (sbuffer)
+        emitSpanBuffer(target);
+
+    if (blend)
+        resolveTranslucency(target);
+    showHeatmap(target);
+
+    stats.faces = mesh.faces.size() - stats.culled;
+}
+
+// ==================================================================================================
+const RenderStats& PolygonRenderer::Stats() const {
+    return stats;
+}
+
+// ==================================================================================================
+void PolygonRenderer::SetShading(PolygonRenderer::Shading shading) {
+    if (this->shading == shading) { return; }
+    this->shading = shading;
+    changed();
+}
+
+// ==================================================================================================
+void PolygonRenderer::SetScene(Scene* scene) {
+    this->scene = scene;
+    changed();
+}
+
+// ==================================================================================================
+void PolygonRenderer::SetAntiAliasing(bool antiAliasing) {
+    if (this->antiAliasing == antiAliasing) { return; }
+    this->antiAliasing = antiAliasing;
+    changed();
+}
+
+// ==================================================================================================
+void PolygonRenderer::SetTexture(const Texture* texture) {
+    if (this->texture == texture) { return; }
+    this->texture = texture;
+    changed();
+}
+
+// ==================================================================================================
+void PolygonRenderer::SetLodTolerance(float pixels) {
+    if (this->lodTolerance == pixels) { return; }
+    this->lodTolerance = pixels;
+    changed();
+}
+
+// ==================================================================================================
+void PolygonRenderer::SetHeatmap(Heatmap heatmap) {
+    if (this->heatmap == heatmap) { return; }
+    this->heatmap = heatmap;
+    changed();
+}
+
+// ==================================================================================================
+PolygonRenderer::Heatmap PolygonRenderer::GetHeatmap() const {
+    return heatmap;
+}
+
+// ==================================================================================================
+void PolygonRenderer::SetShadows(bool shadows) {
+    if (this->shadows == shadows) { return; }
+    this->shadows = shadows;
+    changed();
+}
+
+// ==================================================================================================
+void PolygonRenderer::SetShadowFilter(int radius) {
+    radius = max(radius, 0);
+    if (shadowFilter == radius) { return; }
+    shadowFilter = radius;
+    changed();
+}
+
+// ==================================================================================================
+void PolygonRenderer::SetVisibility(Visibility visibility) {
+    if (this->visibility == visibility) { return; }
+    this->visibility = visibility;
+    changed();
+}
+
+// ==================================================================================================
+// PROTECTED MEMBERS
+// ==================================================================================================
+void PolygonRenderer::changed() {}
+
+// ==================================================================================================
+// PRIVATE MEMBERS
+// ==================================================================================================
+// the edges of the face covering a row into et, by first row
+void PolygonRenderer::prepareEt(const Mesh& mesh, const Face& face, vector<BlocoET>& et) {
+    AllocTracker::Scope scope(AllocTracker::EDGE_TABLE);
+    et.clear();
+    mesh.ForEachEdgeCorners(face, [&](uint32_t ca, uint32_t cb) {
+        // an edge between two row centers covers no sample
+        auto& a = mesh.points[mesh.indices[ca]];
+        auto& b = mesh.points[mesh.indices[cb]];
+        if (CGUtils::FirstSample(a.y()) == CGUtils::FirstSample(b.y())) { return; }
+
+        et.push_back(makeEdge(mesh, face, ca, cb));
+    });
+    std::sort(et.begin(), et.end(), [](const BlocoET& a, const BlocoET& b) { return a.first < b.first; });
+}
+
+// ==================================================================================================
+// steps the AET to row y, taking the edges of the ET from next on that start by then
+void PolygonRenderer::updateAET (int y, vector<BlocoET>& aet, const vector<BlocoET>& et, size_t& next) {
+    AllocTracker::Scope scope(AllocTracker::EDGE_TABLE);
+    //Remove todos os pontos cujo y = ymax
+    aet.erase(std::remove_if(aet.begin(), aet.end(), [y](const BlocoET& val) { return val.ymax == y; }),
+              aet.end());
+
+    //Transfere os valores da ET na posicao y para a AET
+    for (; next < et.size() && et[next].first <= y; next++)
+        aet.push_back(et[next]);
+
+    //Ordena se necessário
+    // by insertion, the AET is nearly sorted from the previous row
+    for (size_t i = 1; i < aet.size(); i++)
+        for (size_t j = i; j > 0 && aet[j].x < aet[j-1].x; j--)
+            std::swap(aet[j], aet[j-1]);
+}
+
+// ==================================================================================================
+// the edge between corners ca and cb, from the upper one down, with the attributes of the shading
+BlocoET PolygonRenderer::makeEdge(const Mesh& mesh, const Face& face, uint32_t ca, uint32_t cb) {
+    auto ia = mesh.indices[ca];
+    auto ib = mesh.indices[cb];
+    auto a = &mesh.points[ia];
+    auto b = &mesh.points[ib];
+    if (a->y() > b->y()) {
+        swap(a, b);
+        swap(ia, ib);
+        swap(ca, cb);
+    }
+
+    auto& weights = mesh.weights;
+    if (face.texture != nullptr)
+        return BlocoET(a->y(), b->y(), a->x(), b->x(),
+                       a->z(), b->z(), weights[ia], weights[ib],
+                       mesh.uvs[ca], mesh.uvs[cb]);
+
+    if (shading == Shading::GOURAUD || (shading == Shading::PHONG && isTranslucent(face))) {
+        auto aColor = litColor(vertexDiffuse[ia], vertexSpecular[ia], face.color);
+        auto bColor = litColor(vertexDiffuse[ib], vertexSpecular[ib], face.color);
+        return BlocoET(a->y(), b->y(), a->x(), b->x(),
+                       a->z(), b->z(), weights[ia], weights[ib],
+                       aColor.red(), bColor.red(),
+                       aColor.green(), bColor.green(),
+                       aColor.blue(), bColor.blue());
+    }
+
+    if (shading == Shading::PHONG) {
+        auto na = mesh.normals[ia];
+        auto nb = mesh.normals[ib];
+        return BlocoET(a->y(), b->y(), a->x(), b->x(),
+                       a->z(), b->z(), weights[ia], weights[ib],
+                       na, nb);
+    }
+
+    return BlocoET(a->y(), b->y(), a->x(), b->x(),
+                   a->z(), b->z(), weights[ia], weights[ib]);
+}
+
+// ==================================================================================================
+// starts the edges of a face (see FaceEdges) and returns its first row
+int PolygonRenderer::beginEdges(const Mesh& mesh, const Face& face) {
+    auto& edges = faceEdges;
+    edges.convex = false;
+    edges.done = false;
+
+    if (face.convex && face.loops == 1) {
+        auto y = [&](uint32_t k) { return mesh.points[mesh.indices[face.first + k]].y(); };
+        uint32_t top = 0, bottom = 0;
+        for (uint32_t k = 1; k < face.count; k++) {
+            if (y(k) < y(top)) { top = k; }
+            if (y(k) > y(bottom)) { bottom = k; }
+        }
+
+        // rounding in the geometry stage may dent a nearly flat loop, the walk needs both
+        // chains to only go down
+        edges.convex = monotoneChains(mesh, face, top, bottom);
+        if (edges.convex) {
+            stats.convex++;
+            if (edges.chains.empty())
+                edges.chains.resize(2, BlocoET(0, 1, 0, 0, 0, 0));
+
+            edges.corner[0] = edges.corner[1] = top;
+            edges.step[0] = 1;
+            edges.step[1] = face.count - 1;
+            edges.bottom = bottom;
+            if (!advanceChain(mesh, face, 0) || !advanceChain(mesh, face, 1)) {
+                edges.done = true;      // flat, no row to fill
+                return 0;
+            }
+            return edges.chains.front().first;
+        }
+    }
+
+    prepareEt(mesh, face, edges.et);
+    edges.next = 0;
+    edges.aet.clear();
+    return edges.et.empty() ? 0 : edges.et.front().first;
+}
+
+// ==================================================================================================
+// the edges of the face on row y, nullptr once it is done
+vector<BlocoET>* PolygonRenderer::activeEdges(const Mesh& mesh, const Face& face, int y) {
+    auto& edges = faceEdges;
+    if (edges.convex) {
+        // an edge ending on this row hands over to the next one of its chain,
+        // both chains reach the bottom on the same row
+        if (!edges.done &&
+            ((edges.chains.front().ymax == y && !advanceChain(mesh, face, 0)) ||
+             (edges.chains.back().ymax == y && !advanceChain(mesh, face, 1))))
+            edges.done = true;
+        if (edges.done) { return nullptr; }
+
+        // the left chain first; they only cross when rounding dented the face
+        auto& left = edges.chains.front();
+        auto& right = edges.chains.back();
+        if (right.x < left.x) {
+            swap(left, right);
+            swap(edges.corner[0], edges.corner[1]);
+            swap(edges.step[0], edges.step[1]);
+        }
+        return &edges.chains;
+    }
+
+    if (edges.next == edges.et.size() && edges.aet.empty()) { return nullptr; }
+    updateAET(y, edges.aet, edges.et, edges.next);
+    return &edges.aet;
+}
+
+// ==================================================================================================
+// both ways around the loop from corner top to corner bottom only go down
+bool PolygonRenderer::monotoneChains(const Mesh& mesh, const Face& face, uint32_t top, uint32_t bottom) const {
+    auto y = [&](uint32_t k) { return mesh.points[mesh.indices[face.first + k]].y(); };
+    for (auto step : {1u, face.count - 1}) {
+        for (auto k = top; k != bottom; k = (k + step) % face.count)
+            if (y((k + step) % face.count) < y(k)) { return false; }
+    }
+    return true;
+}
+
+// ==================================================================================================
+// moves a chain of a convex face to its next edge covering a row, false at the bottom corner
+bool PolygonRenderer::advanceChain(const Mesh& mesh, const Face& face, int chain) {
+    auto& edges = faceEdges;
+    auto& node = edges.chains[chain];
+    while (edges.corner[chain] != edges.bottom) {
+        auto ca = face.first + edges.corner[chain];
+        edges.corner[chain] = (edges.corner[chain] + edges.step[chain]) % face.count;
+        auto cb = face.first + edges.corner[chain];
+
+        auto ya = mesh.points[mesh.indices[ca]].y();
+        auto yb = mesh.points[mesh.indices[cb]].y();
+        if (CGUtils::FirstSample(ya) != CGUtils::FirstSample(yb)) {
+            node = makeEdge(mesh, face, ca, cb);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ==================================================================================================
+QColor PolygonRenderer::shade(QVector3D point, QVector3D normal, const QColor& paintColor) {
+    // Lighting
+    LightBatch single;
+    single.Push(point, normal);
+    shadowBatch(single);
+    lights->Evaluate(single, camera->GetPosition(), shininess);
+    return litColor(single, 0, paintColor);
+}
+
+// ==================================================================================================
+QColor PolygonRenderer::litColor(const QVector3D& diffuse, const QVector3D& specular, const QColor& paintColor) {
+    QColor out;
+    out.setRgbF(clamp01((cteAmb + cteDiff * diffuse.x()) * paintColor.redF() + cteSpec * specular.x()),
+                clamp01((cteAmb + cteDiff * diffuse.y()) * paintColor.greenF() + cteSpec * specular.y()),
+                clamp01((cteAmb + cteDiff * diffuse.z()) * paintColor.blueF() + cteSpec * specular.z()));
+    return out;
+}
+
+// ==================================================================================================
+QColor PolygonRenderer::litColor(const LightBatch& batch, size_t i, const QColor& paintColor) {
+    return litColor(QVector3D(batch.diffR[i], batch.diffG[i], batch.diffB[i]),
+                    QVector3D(batch.specR[i], batch.specG[i], batch.specB[i]),
+                    paintColor);
+}
+
+// ==================================================================================================
+// lights every vertex of the mesh once, for GOURAUD
+void PolygonRenderer::lightVertices(const Mesh& mesh) {
+    auto view = camera->GetPosition();
+    auto n = mesh.points.size();
+    vertexDiffuse.resize(n);
+    vertexSpecular.resize(n);
+
+    for (size_t first = 0; first < n; first += LightBatch::CAPACITY) {
+        batch.count = 0;
+        auto last = min(n, first + LightBatch::CAPACITY);
+        for (auto i = first; i < last; i++)
+            batch.Push(mesh.points[i], mesh.normals[i]);
+
+        shadowBatch(batch);
+        lights->Evaluate(batch, view, shininess);
+        for (auto i = first; i < last; i++) {
+            auto k = i - first;
+            vertexDiffuse[i] = QVector3D(batch.diffR[k], batch.diffG[k], batch.diffB[k]);
+            vertexSpecular[i] = QVector3D(batch.specR[k], batch.specG[k], batch.specB[k]);
+        }
+    }
+}
+
+// ==================================================================================================
+// shades the pixels queued in the batch and writes them to row y
+void PolygonRenderer::flushPhong(const int* xs, int y, QRgb* row, const QColor& paintColor) {
+    if (batch.count == 0) { return; }
+
+    shadowBatch(batch);
+    lights->Evaluate(batch, camera->GetPosition(), shininess);
+    for (size_t i = 0; i < batch.count; i++)
+        row[xs[i]] = litColor(batch, i, paintColor).rgb();
+    if (counters != nullptr)
+        for (size_t i = 0; i < batch.count; i++)
+            counters->Shade(xs[i], y, static_cast<uint32_t>(lights->Size()));
+    batch.count = 0;
+}
+
+// ==================================================================================================
+// rebuilds the shadow map from the world space mesh, only when the geometry or the light moved.
+// The casters are the levels of detail picked for this view; a camera move alone keeps their
+// outlines within the tolerance of the ones drawn, a new tolerance does not.
+void PolygonRenderer::updateShadowMap(const Mesh& mesh) {
+    if (lights->Size() == 0) { return; }
+
+    auto type = lights->Type(0);
+    auto light = lights->Vector(0);
+    bool edited = Vertices.size() >= 3;
+    bool same = shadowBuilt
+            && (edited ? outline == shadowOutline : shadowOutline.empty())
+            && shadowScene == scene && (scene == nullptr || shadowRevision == scene->Revision())
+            && shadowExtrusion == extrusion && shadowLodTolerance == lodTolerance
+            && shadowLightType == type && shadowLight == light;
+    if (same) { return; }
+
+    if (edited)
+        shadowOutline = outline;
+    else
+        shadowOutline.clear();
+    shadowScene = scene;
+    shadowRevision = scene != nullptr ? scene->Revision() : 0;
+    shadowExtrusion = extrusion;
+    shadowLodTolerance = lodTolerance;
+    shadowLightType = type;
+    shadowLight = light;
+
+    shadowMap.Build(mesh, type, light, SHADOW_MAP_SIZE);
+    shadowBuilt = true;
+    stats.shadowMaps++;
+}
+
+// ==================================================================================================
+// the light of the first source reaching every sample of the batch, whose points are on screen
+void PolygonRenderer::shadowBatch(LightBatch& batch) {
+    batch.shadowed = -1;
+    if (!shadows || !shadowBuilt || lights->Size() == 0) { return; }
+
+    batch.shadowed = 0;
+    for (size_t i = 0; i < batch.count; i++) {
+        auto view = frameProjection.Unproject(QVector3D(batch.px[i], batch.py[i], batch.pz[i]));
+        batch.shadow[i] = shadowMap.Visibility(viewToWorld * view, shadowFilter);
+    }
+}
+
+// ==================================================================================================
+QColor PolygonRenderer::flatColor(QVector3D &n, const QColor &c) {
+    auto l = QVector3D(0, 0, -1);   // view direction
+    auto cosTheta = clamp01(QVector3D::dotProduct(n, l));
+    return QColor(static_cast<int>(c.red() * cosTheta),
+                  static_cast<int>(c.green() * cosTheta),
+                  static_cast<int>(c.blue() * cosTheta));
+}
+
+// ==================================================================================================
+// replaces the shaded frame by the counter of the heatmap and sums the counters into the stats
+void PolygonRenderer::showHeatmap(FrameBuffer& frame) {
+    if (counters == nullptr) { return; }
+
+    counters->Sum(stats);
+    auto counter = heatmap == Heatmap::DEPTH_TESTS ? OverdrawCounters::TESTS
+                 : heatmap == Heatmap::WRITES ? OverdrawCounters::WRITES
+                 : OverdrawCounters::SHADES;
+    counters->Paint(counter, frame.Image());
+}
+
+// ==================================================================================================
+// builds the faces of every polyhedron of the frame, then transforms all points at once
+void PolygonRenderer::preparePoints(Mesh& mesh, QColor paintColor, int width, int height) {
+    mesh.Clear();
+
+    // view space is centered on the viewport
+    QMatrix4x4 t1;
+    t1.translate(-width/2, -height/2, 0);
+    QMatrix4x4 rot;
+    auto rotation = camera->GetRotation();
+    rot.rotate(-rotation.x(), 1, 0, 0);
+    rot.rotate(-rotation.y(), 0, 1, 0);
+    rot.rotate(-rotation.z(), 0, 0, 1);
+
+    auto view = rot * t1;
+    auto projection = camera->GetProjection(width, height);
+
+    if (Vertices.size() >= 3) {
+        outline.clear();
+        for (auto v : Vertices) {
+            outline.push_back(v->x());
+            outline.push_back(v->y());
+        }
+        uint32_t contour[] = {0, static_cast<uint32_t>(Vertices.size())};
+        if (outline != lodOutline) {
+            lodOutline = outline;
+            outlineLod.Build(outline.data(), contour, 1);
+        }
+        appendLevel(mesh, outlineLod, outline.data(), contour, 0, 1, this->extrusion, paintColor,
+                    QMatrix4x4(), view, projection, texture);
+    }
+
+    if (scene != nullptr) {
+        if (lodScene != scene || lodRevision != scene->Revision()) {
+            lodScene = scene;
+            lodRevision = scene->Revision();
+            sceneLod.Build(scene->Vertices(), scene->Contours(), scene->ContourCount());
+        }
+        for (size_t i = 0; i < scene->Size(); i++) {
+            auto& polygon = scene->At(i);
+            appendLevel(mesh, sceneLod, scene->Vertices(), scene->Contours(), polygon.firstContour,
+                        polygon.contourCount, polygon.extrusion, polygon.color, polygon.transform,
+                        view, projection, nullptr);
+        }
+        for (size_t i = 0; i < scene->ModelCount(); i++)
+            appendModel(mesh, scene->ModelAt(i));
+    }
+
+    // the shadow map is kept in world space, a camera move alone does not rebuild it
+    if (shadows && shading != Shading::FLAT)
+        updateShadowMap(mesh);
+    viewToWorld = view.inverted();
+    frameProjection = projection;
+
+    // transform all points to view space
+    for (auto& p : mesh.points)
+        p = view * p;
+
+    // then to screen space, nothing behind the near plane or past the far one gets projected
+    clipDepth(mesh, projection);
+
+    mesh.weights.resize(mesh.points.size());
+    for (size_t i = 0; i < mesh.points.size(); i++)
+        mesh.points[i] = projection.Project(mesh.points[i], mesh.weights[i]);
+
+    clipViewport(mesh, width, height);
+}
+
+// ==================================================================================================
+// extrudes contours first..first+count at the coarsest level of detail within the tolerance
+void PolygonRenderer::appendLevel(Mesh& mesh, const OutlineLod& lod, const float* coords, const uint32_t* contours,
+                                size_t first, size_t count, float extrusion,
+                                const QColor& color, const QMatrix4x4& transform,
+                                const QMatrix4x4& view, const Projection& projection,
+                                const Texture* texture) {
+    if (count == 0) { return; }
+
+    auto total = contours[first + count] - contours[first];
+    bool convex = count == 1 && lod.Convex(first);
+    auto minArea = lodArea(lod.Bounds(first), extrusion, view * transform, projection);
+    if (minArea <= 0) {
+        appendExtrusion(mesh, coords, contours + first, count, extrusion, color, transform, texture, convex);
+        stats.vertices += total;
+        return;
+    }
+
+    auto kept = lod.Select(coords, contours, first, count, minArea, lodCoords, lodContours);
+    appendExtrusion(mesh, lodCoords.data(), lodContours.data(), count, extrusion, color, transform, texture, convex);
+    stats.vertices += kept;
+    stats.dropped += total - kept;
+}
+
+// ==================================================================================================
+// smallest Visvalingam-Whyatt area (model units squared) that still covers lodTolerance^2 pixels,
+// from the largest scale the bounding box of the outline gets on screen; 0 keeps every vertex
+float PolygonRenderer::lodArea(const float* bounds, float extrusion, const QMatrix4x4& toView,
+                             const Projection& projection) const {
+    if (!(lodTolerance > 0)) { return 0; }
+
+    // the view only rotates and translates, the model transform may scale
+    auto scale = max(toView.column(0).toVector3D().length(), toView.column(1).toVector3D().length());
+
+    float q = 1;
+    if (projection.Perspective()) {
+        q = 0;
+        for (int i = 0; i < 8; i++) {
+            QVector3D corner(bounds[i & 1 ? 2 : 0], bounds[i & 2 ? 3 : 1], i & 4 ? extrusion : -extrusion);
+            auto w = max(projection.W(toView * corner), projection.nearW);
+            if (!(w > 0)) { return 0; }
+            q = max(q, projection.eye / w);
+        }
+    }
+
+    auto pixels = scale * q * max(abs(projection.sx), abs(projection.sy));
+    return pixels > 0 ? lodTolerance * lodTolerance / (pixels * pixels) : 0;
+}
+
+// ==================================================================================================
+// Sutherland-Hodgman of every loop of a face against distance(p) >= 0. Each loop is clipped on its
+// own (the odd-even fill still gets the right holes), the new loops are appended to the index
+// arrays and split(ia, ib, t) appends the vertex made on the boundary and returns its index.
+// Corner uvs are interpolated perspective-correctly when the clip runs in screen space (weights).
+template <class Distance, class Split>
+static void clipLoops(Mesh& mesh, Face& face, Distance distance, Split split,
+                      const vector<float>* weights = nullptr) {
+    auto& indices = mesh.indices;
+    auto& uvs = mesh.uvs;
+    // clipping a convex loop by a plane leaves it convex
+    Face clipped = {static_cast<uint32_t>(indices.size()), 0,
+                    static_cast<uint32_t>(mesh.loopEnds.size()), 0, face.color, face.texture, face.convex};
+
+    uint32_t begin = face.first;
+    for (uint32_t l = 0; l < face.loops; l++) {
+        uint32_t end = mesh.loopEnds[face.loop + l];
+        auto loopBegin = indices.size();
+
+        for (uint32_t i = begin; i < end; i++) {
+            auto j = i + 1 < end ? i + 1 : begin;
+            auto ia = indices[i];
+            auto ib = indices[j];
+            auto da = distance(mesh.points[ia]);
+            auto db = distance(mesh.points[ib]);
+
+            if (da >= 0)
+                mesh.Corner(ia, uvs[i]);
+            if ((da >= 0) != (db >= 0)) {
+                // split from the lower index, both faces of an edge get the same vertex
+                auto v = ia < ib ? split(ia, ib, da / (da - db)) : split(ib, ia, db / (db - da));
+
+                auto t = da / (da - db);
+                auto ua = uvs[i];
+                auto ub = uvs[j];
+                if (weights != nullptr) {
+                    auto qa = (*weights)[ia] * (1 - t);
+                    auto qb = (*weights)[ib] * t;
+                    mesh.Corner(v, (ua * qa + ub * qb) / (qa + qb));
+                }
+                else {
+                    mesh.Corner(v, ua + t * (ub - ua));
+                }
+            }
+        }
+
+        if (indices.size() - loopBegin < 3) {
+            indices.resize(loopBegin);
+            uvs.resize(loopBegin);
+        }
+        else {
+            mesh.loopEnds.push_back(static_cast<uint32_t>(indices.size()));
+            clipped.loops++;
+        }
+        begin = end;
+    }
+
+    clipped.count = static_cast<uint32_t>(indices.size()) - clipped.first;
+    face = clipped;
+}
+
+// ==================================================================================================
+// against near <= w <= far, in view space
+void PolygonRenderer::clipDepth(Mesh& mesh, const Projection& projection) {
+    if (!projection.Perspective()) { return; }
+
+    auto& points = mesh.points;
+    auto& normals = mesh.normals;
+    auto nearW = projection.nearW;
+    auto farW = projection.farW;
+
+    auto nearDistance = [&](const QVector3D& p) { return projection.W(p) - nearW; };
+    auto farDistance = [&](const QVector3D& p) { return farW - projection.W(p); };
+    auto split = [&](uint32_t ia, uint32_t ib, float t) {
+        auto p = points[ia] + t * (points[ib] - points[ia]);
+        auto n = normals[ia] + t * (normals[ib] - normals[ia]);
+        points.push_back(p);
+        normals.push_back(n);
+        return static_cast<uint32_t>(points.size() - 1);
+    };
+
+    for (auto& face : mesh.faces) {
+        bool beforeNear = false, pastFar = false;
+        for (uint32_t k = 0; k < face.count; k++) {
+            auto& p = mesh.Point(face, k);
+            beforeNear = beforeNear || nearDistance(p) < 0;
+            pastFar = pastFar || farDistance(p) < 0;
+        }
+        if (beforeNear)
+            clipLoops(mesh, face, nearDistance, split);
+        if (pastFar)
+            clipLoops(mesh, face, farDistance, split);
+    }
+}
+
+// ==================================================================================================
+// in screen space: faces off the viewport are rejected, faces inside the guard band are kept as
+// they are (the fill scissors the few pixels outside) and only faces crossing the guard band are
+// clipped to it, so the fill never walks scanlines far away from the frame
+void PolygonRenderer::clipViewport(Mesh& mesh, int width, int height) {
+    auto& points = mesh.points;
+    auto& normals = mesh.normals;
+    auto& weights = mesh.weights;
+    const float left = -GUARD_BAND, top = -GUARD_BAND;
+    const float right = width + GUARD_BAND, bottom = height + GUARD_BAND;
+
+    // screen position is linear, depth and normal are premultiplied by q like in the fill
+    auto split = [&](uint32_t ia, uint32_t ib, float t) {
+        auto qa = weights[ia];
+        auto qb = weights[ib];
+        auto q = qa + t * (qb - qa);
+        auto a = points[ia];
+        auto b = points[ib];
+        auto na = normals[ia] * qa;
+        auto nb = normals[ib] * qb;
+
+        points.push_back(QVector3D(a.x() + t * (b.x() - a.x()),
+                                   a.y() + t * (b.y() - a.y()),
+                                   (a.z() * qa + t * (b.z() * qb - a.z() * qa)) / q));
+        normals.push_back((na + t * (nb - na)) / q);
+        weights.push_back(q);
+        return static_cast<uint32_t>(points.size() - 1);
+    };
+
+    for (auto& face : mesh.faces) {
+        if (face.count == 0) { continue; }
+
+        auto first = mesh.Point(face, 0);
+        float minX = first.x(), maxX = first.x(), minY = first.y(), maxY = first.y();
+        for (uint32_t k = 1; k < face.count; k++) {
+            auto& p = mesh.Point(face, k);
+            minX = min(minX, p.x());
+            maxX = max(maxX, p.x());
+            minY = min(minY, p.y());
+            maxY = max(maxY, p.y());
+        }
+
+        // trivial reject
+        if (maxX < 0 || maxY < 0 || minX >= width || minY >= height) {
+            face.count = 0;
+            face.loops = 0;
+            stats.culled++;
+            continue;
+        }
+
+        // trivial accept
+        if (minX >= left && minY >= top && maxX <= right && maxY <= bottom) { continue; }
+
+        stats.clipped++;
+        if (minX < left)
+            clipLoops(mesh, face, [&](const QVector3D& p) { return p.x() - left; }, split, &weights);
+        if (maxX > right)
+            clipLoops(mesh, face, [&](const QVector3D& p) { return right - p.x(); }, split, &weights);
+        if (minY < top)
+            clipLoops(mesh, face, [&](const QVector3D& p) { return p.y() - top; }, split, &weights);
+        if (maxY > bottom)
+            clipLoops(mesh, face, [&](const QVector3D& p) { return bottom - p.y(); }, split, &weights);
+    }
+}
+
+// ==================================================================================================
+// twice the signed area of a contour of the x,y array
+static double signedArea(const float* coords, uint32_t begin, uint32_t end) {
+    double area = 0;
+    for (uint32_t i = begin; i < end; i++) {
+        auto j = i + 1 < end ? i + 1 : begin;
+        area += static_cast<double>(coords[2*i]) * coords[2*j+1] - static_cast<double>(coords[2*j]) * coords[2*i+1];
+    }
+    return area;
+}
+
+// ==================================================================================================
+// appends all faces of the polyedre extruded from a polygon, the first contour being its outline
+// and the others its holes (contours[c]..contours[c+1] are vertex offsets into coords);
+// the side walls are always convex, the caps when convex says the outline is
+void PolygonRenderer::appendExtrusion(Mesh& mesh, const float* coords, const uint32_t* contours,
+                                    size_t contourCount, float extrusion,
+                                    const QColor& color, const QMatrix4x4& transform,
+                                    const Texture* texture, bool convex) {
+    if (contourCount == 0 || contours[1] - contours[0] < 3) { return; }
+
+    bool model = !transform.isIdentity();
+    auto& points = mesh.points;
+
+    QVector3D frontNormal;
+    double outlineSign = 0;
+    loops.clear();
+
+    for (size_t c = 0; c < contourCount; c++) {
+        auto begin = contours[c];
+        auto n = contours[c+1] - begin;
+        if (n < 3) { continue; }
+
+        // front and back: front vertex i is base + i, back vertex i is base + n + i
+        auto base = static_cast<uint32_t>(points.size());
+        for (uint32_t i = begin; i < begin + n; i++) {
+            QVector3D p(coords[2*i], coords[2*i+1], -extrusion);
+            points.push_back(model ? transform * p : p);
+        }
+        for (uint32_t i = begin; i < begin + n; i++) {
+            QVector3D p(coords[2*i], coords[2*i+1], extrusion);
+            points.push_back(model ? transform * p : p);
+        }
+
+        bool reversed;
+        auto area = signedArea(coords, begin, begin + n);
+        if (c == 0) {
+            frontNormal = QVector3D::normal(points[base] - points[base + 1], points[base + 2] - points[base + 1]);
+            reversed = frontNormal.z() > 0;
+            outlineSign = reversed ? -area : area;
+        }
+        else {
+            // holes run against the outline so their side walls face into the hole
+            reversed = (area > 0) == (outlineSign > 0);
+        }
+        loops.push_back({base, begin, n, reversed});
+    }
+
+    // caps map the texture once over the bounding box of the outline (model space)
+    float minX = coords[2*contours[0]], minY = coords[2*contours[0]+1];
+    float extent = 0;
+    {
+        float maxX = minX, maxY = minY;
+        for (uint32_t i = contours[0]; i < contours[1]; i++) {
+            minX = min(minX, coords[2*i]);
+            maxX = max(maxX, coords[2*i]);
+            minY = min(minY, coords[2*i+1]);
+            maxY = max(maxY, coords[2*i+1]);
+        }
+        extent = max(max(maxX - minX, maxY - minY), 1.0f);
+    }
+    auto capUv = [&](const ExtrudedLoop& loop, uint32_t v) {
+        auto k = loop.first + (v - loop.base) % loop.n;
+        return QVector2D((coords[2*k] - minX) / extent, (coords[2*k+1] - minY) / extent);
+    };
+
+    auto backNormal = -frontNormal;
+    for (auto& loop : loops) {
+        mesh.normals.insert(mesh.normals.end(), loop.n, frontNormal / 3);
+        mesh.normals.insert(mesh.normals.end(), loop.n, backNormal / 3);
+    }
+
+    // side walls, u runs along the perimeter and v across the extrusion
+    for (auto& loop : loops) {
+        auto n = loop.n;
+        wallU.assign(1, 0.0f);
+        for (uint32_t i = 0; i < n; i++) {
+            auto a = capUv(loop, loop.Front(i));
+            auto b = capUv(loop, loop.Front((i+1)%n));
+            wallU.push_back(wallU.back() + (b - a).length());
+        }
+        auto perimeter = max(wallU.back(), 1e-6f);
+
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t face[] = {loop.Back(i), loop.Back((i+1)%n), loop.Front((i+1)%n), loop.Front(i)};
+            auto u0 = wallU[i] / perimeter;
+            auto u1 = wallU[i+1] / perimeter;
+            mesh.BeginFace(color, texture, true);
+            mesh.Corner(face[0], QVector2D(u0, 1));
+            mesh.Corner(face[1], QVector2D(u1, 1));
+            mesh.Corner(face[2], QVector2D(u1, 0));
+            mesh.Corner(face[3], QVector2D(u0, 0));
+            mesh.EndLoop();
+
+            auto normal = QVector3D::normal(points[face[0]] - points[face[1]], points[face[2]] - points[face[1]]);
+            for (auto v : face)
+                mesh.normals[v] += normal / 3;
+        }
+    }
+
+    // caps
+    convex = convex && loops.size() == 1;
+    mesh.BeginFace(color, texture, convex);
+    for (auto& loop : loops) {
+        for (uint32_t i = 0; i < loop.n; i++)
+            mesh.Corner(loop.Front(i), capUv(loop, loop.Front(i)));
+        mesh.EndLoop();
+    }
+
+    mesh.BeginFace(color, texture, convex);
+    for (auto& loop : loops) {
+        for (uint32_t i = 0; i < loop.n; i++)
+            mesh.Corner(loop.Back(loop.n - 1 - i), capUv(loop, loop.Back(loop.n - 1 - i)));
+        mesh.EndLoop();
+    }
+}
+
+// ==================================================================================================
+// copies a loaded mesh as it is, faces reversed to the clockwise screen order of the extrusions
+void PolygonRenderer::appendModel(Mesh& mesh, const Model& model) {
+    auto& points = mesh.points;
+    auto base = static_cast<uint32_t>(points.size());
+    auto vertexCount = model.VertexCount();
+    auto positions = model.positions.data();
+    auto normals = model.Normals();
+
+    points.reserve(points.size() + vertexCount);
+    mesh.normals.reserve(mesh.normals.size() + vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        QVector3D p(positions[3*v], positions[3*v+1], positions[3*v+2]);
+        QVector3D n(normals[3*v], normals[3*v+1], normals[3*v+2]);
+        points.push_back(model.transform * p);
+        mesh.normals.push_back(model.transform.mapVector(n).normalized());
+    }
+
+    mesh.indices.reserve(mesh.indices.size() + model.indices.size());
+    mesh.uvs.reserve(mesh.uvs.size() + model.indices.size());
+    for (size_t f = 0; f < model.FaceCount(); f++) {
+        mesh.BeginFace(model.color, nullptr, model.Convex(f));
+        for (auto k = model.faces[f + 1]; k > model.faces[f]; k--)
+            mesh.Corner(base + model.indices[k - 1], QVector2D());
+        mesh.EndLoop();
+    }
+    stats.vertices += vertexCount;
+}
+
+// ==================================================================================================
+void PolygonRenderer::oddEvenFillMethodFLAT(const Mesh& mesh,
+                                          const Face& face,
+                                          FrameBuffer& frame) {
+    // Lighting
+    QColor diffColor = face.color;
+    auto normal = QVector3D::normal(mesh.Point(face, 0) - mesh.Point(face, 1),
+                                    mesh.Point(face, 2) - mesh.Point(face, 1));
+    diffColor = flatColor(normal, diffColor);
+
+    // the visible runs are written straight into the row, a QPainter allocates its state
+    auto color = diffColor.rgb();
+    auto drawLine = [&](int x0, int x1, int y) {
+        auto row = frame.Row(y);
+        std::fill(row + x0, row + x1 + 1, color);
+    };
+
+    bool sbuffer = spanBuffered;
+    auto faceIndex = static_cast<uint32_t>(&face - mesh.faces.data());
+    if (sbuffer) { faceColors[faceIndex] = color; }
+
+    // Inicializa a ET e a AET, or the two chains of a convex face
+    int y = beginEdges(mesh, face);
+    int width = frame.Width();
+    int height = frame.Height();
+
+    vector<BlocoET>* aet;
+    while (y < height && (aet = activeEdges(mesh, face, y)) != nullptr) {
+        //Desenha as linhas e incrementa os valores de x para a proxima iteracao
+        auto it = aet->begin();
+        while (it != aet->end()) {
+            // 1st line
+            auto x_beg = CGUtils::FirstSample(it->x);
+            auto x_left = it->x;
+            auto q_beg = it->q;
+            double zq_beg[] = {it->z};
+            it->x += it->mx;
+            it->q += it->mq;
+            it->z += it->mz;
+            it++;
+
+            // 2nd line
+            auto x_end = CGUtils::FirstSample(it->x);
+            auto x_right = it->x;
+            auto q_end = it->q;
+            double zq_end[] = {it->z};
+            it->x += it->mx;
+            it->q += it->mq;
+            it->z += it->mz;
+            it++;
+
+            if (y < 0) continue;
+
+            // Z-BUFFER
+            int x_init_z = -1;
+            int x_end_z = -1;
+
+            int x = max(x_beg, 0);
+
+            if (x >= x_end || x >= width) continue;
+
+            if (sbuffer) {
+                double aq_beg[SpanBuffer::ATTRIBUTES] = {zq_beg[0]};
+                double aq_end[SpanBuffer::ATTRIBUTES] = {zq_end[0]};
+                spanBuffer.Insert(y, SpanBuffer::Ramp(faceIndex, x, min(x_end, width) - 1, x_left, x_right,
+                                                      q_beg, aq_beg, q_end, aq_end));
+                continue;
+            }
+
+            SpanStepper<1> span;
+            span.Begin(zq_beg, q_beg, zq_end, q_end, x_right - x_left, x + 0.5 - x_left, min(x_end, width) - x);
+
+            while(x < x_end && x < width) {
+                auto z = span.a[0];
+                if (testDepth(frame, x, y, z)) {
+                    if (x_init_z < 0) x_init_z = x;
+                    x_end_z = x;
+                    frame.Depth(x, y) = static_cast<int>(z);
+                }
+                else  {
+                    if (x_init_z != -1)
+                        drawLine(x_init_z, x_end_z, y);
+                    x_init_z = -1;
+                }
+
+                x++;
+                span.Next();
+            }
+
+            if (x_init_z != -1)
+                drawLine(x_init_z, x_end_z, y);
+        }
+
+        y++;
+    }
+}
+
+// ==================================================================================================
+// the colors are interpolated perspective-correctly, so the visible pixels are written
+// straight into the frame instead of through a screen-space gradient
+void PolygonRenderer::oddEvenFillMethodGOURAULD(const Mesh& mesh,
+                                      const Face& face,
+                                      FrameBuffer& frame) {
+    bool sbuffer = spanBuffered;
+    auto faceIndex = static_cast<uint32_t>(&face - mesh.faces.data());
+
+    // Inicializa a ET e a AET, or the two chains of a convex face
+    int y = beginEdges(mesh, face);
+    int width = frame.Width();
+    int height = frame.Height();
+
+    vector<BlocoET>* aet;
+    while (y < height && (aet = activeEdges(mesh, face, y)) != nullptr) {
+        //Desenha as linhas e incrementa os valores de x para a proxima iteracao
+        auto it = aet->begin();
+        while (it != aet->end()) {
+            // 1st line
+            auto x_beg = CGUtils::FirstSample(it->x);
+            auto x_left = it->x;
+            auto q_beg = it->q;
+            double aq_beg[] = {it->z, it->r, it->g, it->b};
+            it->x += it->mx;
+            it->q += it->mq;
+            it->z += it->mz;
+            it->r += it->mr;
+            it->g += it->mg;
+            it->b += it->mb;
+            it++;
+
+            // 2nd line
+            auto x_end = CGUtils::FirstSample(it->x);
+            auto x_right = it->x;
+            auto q_end = it->q;
+            double aq_end[] = {it->z, it->r, it->g, it->b};
+            it->x += it->mx;
+            it->q += it->mq;
+            it->z += it->mz;
+            it->r += it->mr;
+            it->g += it->mg;
+            it->b += it->mb;
+            it++;
+
+            if (y < 0) continue;
+
+            // Z-BUFFER
+            int x = max(x_beg, 0);
+
+            if (x >= x_end || x >= width) continue;
+
+            if (sbuffer) {
+                spanBuffer.Insert(y, SpanBuffer::Ramp(faceIndex, x, min(x_end, width) - 1, x_left, x_right,
+                                                      q_beg, aq_beg, q_end, aq_end));
+                continue;
+            }
+
+            SpanStepper<4> span;
+            span.Begin(aq_beg, q_beg, aq_end, q_end, x_right - x_left, x + 0.5 - x_left, min(x_end, width) - x);
+
+            auto row = frame.Row(y);
+            while(x < x_end && x < width) {
+                auto z = span.a[0];
+                if (testDepth(frame, x, y, z)) {
+                    frame.Depth(x, y) = static_cast<int>(z);
+                    row[x] = qRgb(qBound(0, static_cast<int>(span.a[1]), 255),
+                                  qBound(0, static_cast<int>(span.a[2]), 255),
+                                  qBound(0, static_cast<int>(span.a[3]), 255));
+                }
+
+                x++;
+                span.Next();
+            }
+        }
+
+        y++;
+    }
+}
+
+// ==================================================================================================
+void PolygonRenderer::oddEvenFillMethodPHONG(const Mesh& mesh,
+                                           const Face& face,
+                                           FrameBuffer& frame) {
+    // visible pixels are queued and lit a batch at a time
+    int xs[LightBatch::CAPACITY];
+    batch.count = 0;
+
+    // Inicializa a ET e a AET, or the two chains of a convex face
+    int y = beginEdges(mesh, face);
+    int width = frame.Width();
+    int height = frame.Height();
+
+    vector<BlocoET>* aet;
+    while (y < height && (aet = activeEdges(mesh, face, y)) != nullptr) {
+        //Desenha as linhas e incrementa os valores de x para a proxima iteracao
+        auto it = aet->begin();
+        while (it != aet->end()) {
+            // 1st line
+            auto x_beg = CGUtils::FirstSample(it->x);
+            auto x_left = it->x;
+            auto q_beg = it->q;
+            double aq_beg[] = {it->z, it->n.x(), it->n.y(), it->n.z()};
+            it->x += it->mx;
+            it->q += it->mq;
+            it->z += it->mz;
+            it->n += it->mn;
+            it++;
+
+            // 2nd line
+            auto x_end = CGUtils::FirstSample(it->x);
+            auto x_right = it->x;
+            auto q_end = it->q;
+            double aq_end[] = {it->z, it->n.x(), it->n.y(), it->n.z()};
+            it->x += it->mx;
+            it->q += it->mq;
+            it->z += it->mz;
+            it->n += it->mn;
+            it++;
+
+            // Z-BUFFER
+            if (y < 0) continue;
+
+            // Z-BUFFER
+            int x = max(x_beg, 0);
+
+            if (x >= x_end || x >= width) continue;
+
+            SpanStepper<4> span;
+            span.Begin(aq_beg, q_beg, aq_end, q_end, x_right - x_left, x + 0.5 - x_left, min(x_end, width) - x);
+
+            auto row = frame.Row(y);
+            while(x < x_end && x < width) {
+                auto z = static_cast<int>(span.a[0]);
+                if (testDepth(frame, x, y, z)) {
+                    frame.Depth(x, y) = z;
+                    xs[batch.count] = x;
+                    batch.Push(QVector3D(x, y, z), QVector3D(static_cast<float>(span.a[1]),
+                                                             static_cast<float>(span.a[2]),
+                                                             static_cast<float>(span.a[3])));
+                    if (batch.Full())
+                        flushPhong(xs, y, row, face.color);
+                }
+
+                x++;
+                span.Next();
+            }
+            flushPhong(xs, y, row, face.color);
+        }
+
+        y++;
+    }
+}
+
+// ==================================================================================================
+// Texels modulated by the flat lighting of the face. u and v are stepped perspective-correctly,
+// and the mip level is picked once per span from the texel footprint of a pixel, measured
+// along the span and down its left edge.
+void PolygonRenderer::oddEvenFillMethodTEXTURE(const Mesh& mesh,
+                                             const Face& face,
+                                             FrameBuffer& frame) {
+    auto& texture = *face.texture;
+    if (texture.IsNull()) { return; }
+
+    // Lighting
+    auto normal = QVector3D::normal(mesh.Point(face, 0) - mesh.Point(face, 1),
+                                    mesh.Point(face, 2) - mesh.Point(face, 1));
+    auto light = static_cast<int>(clamp01(QVector3D::dotProduct(normal, QVector3D(0, 0, -1))) * 256);
+    double texelsX = texture.Width();
+    double texelsY = texture.Height();
+
+    // Inicializa a ET e a AET, or the two chains of a convex face
+    int y = beginEdges(mesh, face);
+    int width = frame.Width();
+    int height = frame.Height();
+
+    vector<BlocoET>* aet;
+    while (y < height && (aet = activeEdges(mesh, face, y)) != nullptr) {
+        //Desenha as linhas e incrementa os valores de x para a proxima iteracao
+        auto it = aet->begin();
+        while (it != aet->end()) {
+            // 1st line
+            auto x_beg = CGUtils::FirstSample(it->x);
+            auto x_left = it->x;
+            auto q_beg = it->q;
+            double aq_beg[] = {it->z, it->u, it->v};
+            it->x += it->mx;
+            it->q += it->mq;
+            it->z += it->mz;
+            it->u += it->mu;
+            it->v += it->mv;
+            auto x_down = it->x;
+            auto u_down = it->u / it->q;
+            auto v_down = it->v / it->q;
+            it++;
+
+            // 2nd line
+            auto x_end = CGUtils::FirstSample(it->x);
+            auto x_right = it->x;
+            auto q_end = it->q;
+            double aq_end[] = {it->z, it->u, it->v};
+            it->x += it->mx;
+            it->q += it->mq;
+            it->z += it->mz;
+            it->u += it->mu;
+            it->v += it->mv;
+            it++;
+
+            if (y < 0) continue;
+
+            // Z-BUFFER
+            int x = max(x_beg, 0);
+
+            if (x >= x_end || x >= width) continue;
+
+            // MIP LEVEL
+            auto u0 = aq_beg[1] / q_beg, v0 = aq_beg[2] / q_beg;
+            auto u1 = aq_end[1] / q_end, v1 = aq_end[2] / q_end;
+            auto span_dx = max(x_right - x_left, 1.0);
+            auto du_dx = (u1 - u0) / span_dx, dv_dx = (v1 - v0) / span_dx;
+            auto du_dy = (u_down - u0) - du_dx * (x_down - x_left);
+            auto dv_dy = (v_down - v0) - dv_dx * (x_down - x_left);
+            auto footprint = max(hypot(du_dx * texelsX, dv_dx * texelsY), hypot(du_dy * texelsX, dv_dy * texelsY));
+            auto level = texture.Level(static_cast<float>(footprint));
+
+            SpanStepper<3> span;
+            span.Begin(aq_beg, q_beg, aq_end, q_end, x_right - x_left, x + 0.5 - x_left, min(x_end, width) - x);
+
+            auto row = frame.Row(y);
+            while(x < x_end && x < width) {
+                auto z = span.a[0];
+                if (testDepth(frame, x, y, z)) {
+                    frame.Depth(x, y) = static_cast<int>(z);
+                    auto texel = texture.Sample(level, static_cast<float>(span.a[1]), static_cast<float>(span.a[2]));
+                    row[x] = qRgb((qRed(texel) * light) >> 8,
+                                  (qGreen(texel) * light) >> 8,
+                                  (qBlue(texel) * light) >> 8);
+                }
+
+                x++;
+                span.Next();
+            }
+        }
+
+        y++;
+    }
+}
+
+// ==================================================================================================
+// Records the spans of a translucent face in the A-buffer, colored like the GOURAUD fill (one
+// flat color under FLAT shading); nothing reaches the frame until the rows are resolved.
+void PolygonRenderer::translucentFill(const Mesh& mesh,
+                                    const Face& face,
+                                    FrameBuffer& frame) {
+    bool flat = shading == Shading::FLAT;
+    QColor flatLit;
+    if (flat) {
+        auto normal = QVector3D::normal(mesh.Point(face, 0) - mesh.Point(face, 1),
+                                        mesh.Point(face, 2) - mesh.Point(face, 1));
+        flatLit = flatColor(normal, face.color);
+    }
+    auto faceIndex = static_cast<uint32_t>(&face - mesh.faces.data());
+    auto alpha = face.color.alpha();
+    stats.translucent++;
+
+    // Inicializa a ET e a AET, or the two chains of a convex face
+    int y = beginEdges(mesh, face);
+    int width = frame.Width();
+    int height = frame.Height();
+
+    vector<BlocoET>* aet;
+    while (y < height && (aet = activeEdges(mesh, face, y)) != nullptr) {
+        auto it = aet->begin();
+        while (it != aet->end()) {
+            // 1st line
+            auto x_beg = CGUtils::FirstSample(it->x);
+            auto x_left = it->x;
+            auto q_beg = it->q;
+            double aq_beg[] = {it->z, flatLit.red() * q_beg, flatLit.green() * q_beg, flatLit.blue() * q_beg};
+            if (!flat) {
+                aq_beg[1] = it->r;
+                aq_beg[2] = it->g;
+                aq_beg[3] = it->b;
+                it->r += it->mr;
+                it->g += it->mg;
+                it->b += it->mb;
+            }
+            it->x += it->mx;
+            it->q += it->mq;
+            it->z += it->mz;
+            it++;
+
+            // 2nd line
+            auto x_end = CGUtils::FirstSample(it->x);
+            auto x_right = it->x;
+            auto q_end = it->q;
+            double aq_end[] = {it->z, flatLit.red() * q_end, flatLit.green() * q_end, flatLit.blue() * q_end};
+            if (!flat) {
+                aq_end[1] = it->r;
+                aq_end[2] = it->g;
+                aq_end[3] = it->b;
+                it->r += it->mr;
+                it->g += it->mg;
+                it->b += it->mb;
+            }
+            it->x += it->mx;
+            it->q += it->mq;
+            it->z += it->mz;
+            it++;
+
+            if (y < 0) continue;
+
+            int x = max(x_beg, 0);
+
+            if (x >= x_end || x >= width) continue;
+
+            aBuffer.Insert(y, SpanBuffer::Ramp(faceIndex, x, min(x_end, width) - 1, x_left, x_right,
+                                               q_beg, aq_beg, q_end, aq_end), alpha);
+        }
+
+        y++;
+    }
+}
+
+// ==================================================================================================
+// every face is shaded once per frame and every pixel written once, the depth buffer is unused
+void PolygonRenderer::scanlineFill(const Mesh& mesh, FrameBuffer& frame) {
+    faceColors.resize(mesh.faces.size());
+    for (size_t f = 0; f < mesh.faces.size(); f++) {
+        auto& face = mesh.faces[f];
+        if (face.count < 3) { continue; }
+        auto normal = QVector3D::normal(mesh.Point(face, 0) - mesh.Point(face, 1),
+                                        mesh.Point(face, 2) - mesh.Point(face, 1));
+        faceColors[f] = flatColor(normal, face.color).rgb();
+    }
+
+    scanline.Resolve(mesh, frame.Width(), frame.Height(), camera->isPerspective);
+    for (auto& span : scanline.Spans()) {
+        std::fill(frame.Row(span.y) + span.x0, frame.Row(span.y) + span.x1 + 1, faceColors[span.face]);
+        if (counters != nullptr)
+            for (int x = span.x0; x <= span.x1; x++)
+                counters->Write(x, span.y);
+    }
+}
+
+// ==================================================================================================
+// the visible segments left in the S-buffer, each pixel written once
+void PolygonRenderer::emitSpanBuffer(FrameBuffer& frame) {
+    for (int y = 0; y < spanBuffer.Height(); y++) {
+        auto row = frame.Row(y);
+        for (auto& s : spanBuffer.Row(y)) {
+            if (counters != nullptr)
+                for (int x = s.x0; x <= s.x1; x++)
+                    counters->Write(x, y);
+
+            if (shading == Shading::FLAT) {
+                std::fill(row + s.x0, row + s.x1 + 1, faceColors[s.face]);
+                continue;
+            }
+
+            int n = s.x1 - s.x0 + 1;
+            double aqEnd[SpanBuffer::ATTRIBUTES];
+            for (int k = 0; k < SpanBuffer::ATTRIBUTES; k++)
+                aqEnd[k] = s.aq[k] + n * s.daq[k];
+
+            SpanStepper<SpanBuffer::ATTRIBUTES> span;
+            span.Begin(s.aq, s.q, aqEnd, s.q + n * s.dq, n, 0, n);
+            for (int x = s.x0; x <= s.x1; x++) {
+                row[x] = qRgb(qBound(0, static_cast<int>(span.a[1]), 255),
+                              qBound(0, static_cast<int>(span.a[2]), 255),
+                              qBound(0, static_cast<int>(span.a[3]), 255));
+                span.Next();
+            }
+        }
+    }
+}
+
+// ==================================================================================================
+// the translucent spans of every row, blended back to front over the opaque pixels
+void PolygonRenderer::resolveTranslucency(FrameBuffer& frame) {
+    for (int y = 0; y < frame.Height(); y++)
+        stats.fragments += aBuffer.Resolve(y, frame.Row(y), &frame.Depth(0, y), counters);
+}
+
+// ==================================================================================================
+// blends src over dst with a coverage in [0, 256], both premultiplied
+static inline QRgb blendCoverage(QRgb src, QRgb dst, uint a) {
+    auto rb = (((src & 0xff00ff) * a + (dst & 0xff00ff) * (256 - a)) >> 8) & 0xff00ff;
+    auto ag = ((((src >> 8) & 0xff00ff) * a + ((dst >> 8) & 0xff00ff) * (256 - a)) >> 8) & 0xff00ff;
+    return rb | (ag << 8);
+}
+
+// ==================================================================================================
+// Same odd-even AET walk as the other fills, but the AET only provides the depth and shading
+// ramps of each row. Which pixels are painted, and how much, comes from the exact coverage of
+// the face: runs fully inside are stepped like the spans of the other fills, edge pixels are
+// blended by their coverage. Textured faces are lit as in oddEvenFillMethodTEXTURE, with the
+// mip level taken along each span only.
+void PolygonRenderer::antiAliasedFill(const Mesh& mesh,
+                                    const Face& face,
+                                    FrameBuffer& frame) {
+    int width = frame.Width();
+    int height = frame.Height();
+
+    // PHONG pixels of the covered runs are queued and lit a batch at a time
+    int xs[LightBatch::CAPACITY];
+    batch.count = 0;
+
+    coverage.Reset();
+    mesh.ForEachEdge(face, [&](uint32_t ia, uint32_t ib) {
+        auto& a = mesh.points[ia];
+        auto& b = mesh.points[ib];
+        coverage.AddEdge(a.x(), a.y(), b.x(), b.y());
+    });
+
+    // makeEdge gives textured faces texture coordinates in place of any shading
+    auto texture = face.texture;
+    if (texture != nullptr && texture->IsNull()) { return; }
+
+    QRgb flat = 0;
+    int light = 0;
+    if (texture != nullptr) {
+        auto normal = QVector3D::normal(mesh.Point(face, 0) - mesh.Point(face, 1),
+                                        mesh.Point(face, 2) - mesh.Point(face, 1));
+        light = static_cast<int>(clamp01(QVector3D::dotProduct(normal, QVector3D(0, 0, -1))) * 256);
+    }
+    else if (shading == Shading::FLAT) {
+        auto normal = QVector3D::normal(mesh.Point(face, 0) - mesh.Point(face, 1),
+                                        mesh.Point(face, 2) - mesh.Point(face, 1));
+        flat = flatColor(normal, face.color).rgb();
+    }
+
+    auto mipLevel = [&](SpanRamp& r) {
+        if (texture == nullptr) { return; }
+        auto span_dx = max(r.x1 - r.x0, 1.0);
+        auto du = (r.u1 / r.q1 - r.u0 / r.q0) * texture->Width();
+        auto dv = (r.v1 / r.q1 - r.v0 / r.q0) * texture->Height();
+        r.level = texture->Level(static_cast<float>(hypot(du, dv) / span_dx));
+    };
+    auto texel = [&](const SpanRamp& r, double u, double v) {
+        auto t = texture->Sample(r.level, static_cast<float>(u), static_cast<float>(v));
+        return qRgb((qRed(t) * light) >> 8, (qGreen(t) * light) >> 8, (qBlue(t) * light) >> 8);
+    };
+
+    // Inicializa a ET e a AET, or the two chains of a convex face
+    int yAet = beginEdges(mesh, face);
+    ramps.clear();
+
+    auto yEnd = min(coverage.Bottom(), height);
+    for (int y = coverage.Top(); y < yEnd; y++) {
+        // steps the AET up to this row, a row past its end keeps the last ramps; so does the
+        // row the AET empties on, the chains of a convex face end without emptying. The rows
+        // above the first one of the AET take its ramps, clamped to their ends.
+        vector<BlocoET>* aet;
+        while ((yAet <= y || ramps.empty()) && (aet = activeEdges(mesh, face, yAet)) != nullptr) {
+            yAet++;
+            if (aet->empty()) { continue; }
+            ramps.clear();
+
+            auto it = aet->begin();
+            while (it != aet->end()) {
+                auto b = it++;
+                if (it == aet->end()) { break; }
+                auto e = it++;
+
+                SpanRamp ramp;
+                ramp.x0 = b->x;
+                ramp.x1 = e->x;
+                ramp.q0 = b->q;
+                ramp.q1 = e->q;
+                ramp.z0 = b->z;
+                ramp.z1 = e->z;
+                if (texture != nullptr) {
+                    ramp.u0 = b->u; ramp.v0 = b->v;
+                    ramp.u1 = e->u; ramp.v1 = e->v;
+                    mipLevel(ramp);
+                }
+                else if (shading == Shading::GOURAUD) {
+                    ramp.r0 = b->r; ramp.g0 = b->g; ramp.b0 = b->b;
+                    ramp.r1 = e->r; ramp.g1 = e->g; ramp.b1 = e->b;
+                }
+                else if (shading == Shading::PHONG) {
+                    ramp.n0 = b->n;
+                    ramp.n1 = e->n;
+                }
+                ramps.push_back(ramp);
+
+                for (auto edge : {b, e}) {
+                    edge->x += edge->mx;
+                    edge->q += edge->mq;
+                    edge->z += edge->mz;
+                    if (texture != nullptr) {
+                        edge->u += edge->mu;
+                        edge->v += edge->mv;
+                    }
+                    else if (shading == Shading::GOURAUD) {
+                        edge->r += edge->mr;
+                        edge->g += edge->mg;
+                        edge->b += edge->mb;
+                    }
+                    else if (shading == Shading::PHONG) {
+                        edge->n += edge->mn;
+                    }
+                }
+            }
+        }
+
+        if (ramps.empty()) {
+            ramps.push_back(sliverRamp(mesh, face));
+            mipLevel(ramps.back());
+        }
+        if (y < 0) { continue; }
+
+        auto row = frame.Row(y);
+        size_t s = 0;
+
+        // a = coverage in [0, 256]
+        auto paint = [&](int x, uint a) {
+            auto xc = x + 0.5;
+            // nearest span of the row, pixels are visited left to right
+            while (s + 1 < ramps.size() && xc - ramps[s].x1 > ramps[s + 1].x0 - xc) s++;
+            auto& r = ramps[s];
+
+            auto t = r.x1 > r.x0 ? (xc - r.x0) / (r.x1 - r.x0) : 0.0;
+            t = t < 0 ? 0 : (t > 1 ? 1 : t);
+
+            // perspective-correct, this path divides by q at every pixel
+            auto w = 1 / (r.q0 + t * (r.q1 - r.q0));
+            auto z = (r.z0 + t * (r.z1 - r.z0)) * w;
+            auto& depth = frame.Depth(x, y);
+            if (counters != nullptr) { counters->Test(x, y, depth > z); }
+            if (depth <= z) { return; }
+
+            QRgb color;
+            if (texture != nullptr) {
+                color = texel(r, (r.u0 + t * (r.u1 - r.u0)) * w, (r.v0 + t * (r.v1 - r.v0)) * w);
+            }
+            else if (shading == Shading::GOURAUD) {
+                color = qRgb(qBound(0, static_cast<int>((r.r0 + t * (r.r1 - r.r0)) * w), 255),
+                             qBound(0, static_cast<int>((r.g0 + t * (r.g1 - r.g0)) * w), 255),
+                             qBound(0, static_cast<int>((r.b0 + t * (r.b1 - r.b0)) * w), 255));
+            }
+            else if (shading == Shading::PHONG) {
+                auto n = (r.n0 + static_cast<float>(t) * (r.n1 - r.n0)) * static_cast<float>(w);
+                color = shade(QVector3D(x, y, static_cast<int>(z)), n, face.color).rgb();
+                if (counters != nullptr) { counters->Shade(x, y, static_cast<uint32_t>(lights->Size())); }
+            }
+            else {
+                color = flat;
+            }
+
+            if (a >= 256) {
+                row[x] = color;
+                depth = static_cast<int>(z);
+            }
+            else {
+                row[x] = blendCoverage(color, row[x], a);
+                if (a >= 128) { depth = static_cast<int>(z); }
+            }
+        };
+
+        // pixels x .. end - 1 fully covered: inside the samples of their nearest span they are
+        // stepped along it as in the other fills, outside they clamp to its ends through paint
+        auto fillCovered = [&](int x, int end) {
+            while (x < end) {
+                auto xc = x + 0.5;
+                while (s + 1 < ramps.size() && xc - ramps[s].x1 > ramps[s + 1].x0 - xc) s++;
+                auto& r = ramps[s];
+
+                // the spans of the AET do not overlap, this one stays the nearest to its end
+                auto x_end = min(CGUtils::FirstSample(r.x1), end);
+                if (x < CGUtils::FirstSample(r.x0) || x >= x_end) {
+                    paint(x++, 256);
+                    continue;
+                }
+
+                double aq_beg[] = {r.z0, 0, 0, 0};
+                double aq_end[] = {r.z1, 0, 0, 0};
+                if (texture != nullptr) {
+                    aq_beg[1] = r.u0; aq_beg[2] = r.v0;
+                    aq_end[1] = r.u1; aq_end[2] = r.v1;
+                }
+                else if (shading == Shading::GOURAUD) {
+                    aq_beg[1] = r.r0; aq_beg[2] = r.g0; aq_beg[3] = r.b0;
+                    aq_end[1] = r.r1; aq_end[2] = r.g1; aq_end[3] = r.b1;
+                }
+                else if (shading == Shading::PHONG) {
+                    aq_beg[1] = r.n0.x(); aq_beg[2] = r.n0.y(); aq_beg[3] = r.n0.z();
+                    aq_end[1] = r.n1.x(); aq_end[2] = r.n1.y(); aq_end[3] = r.n1.z();
+                }
+
+                SpanStepper<4> span;
+                span.Begin(aq_beg, r.q0, aq_end, r.q1, r.x1 - r.x0, xc - r.x0, x_end - x);
+                for (; x < x_end; x++, span.Next()) {
+                    auto z = span.a[0];
+                    if (!testDepth(frame, x, y, z)) { continue; }
+                    frame.Depth(x, y) = static_cast<int>(z);
+
+                    if (texture != nullptr) {
+                        row[x] = texel(r, span.a[1], span.a[2]);
+                    }
+                    else if (shading == Shading::GOURAUD) {
+                        row[x] = qRgb(qBound(0, static_cast<int>(span.a[1]), 255),
+                                      qBound(0, static_cast<int>(span.a[2]), 255),
+                                      qBound(0, static_cast<int>(span.a[3]), 255));
+                    }
+                    else if (shading == Shading::PHONG) {
+                        xs[batch.count] = x;
+                        batch.Push(QVector3D(x, y, static_cast<int>(z)), QVector3D(static_cast<float>(span.a[1]),
+                                                                                   static_cast<float>(span.a[2]),
+                                                                                   static_cast<float>(span.a[3])));
+                        if (batch.Full())
+                            flushPhong(xs, y, row, face.color);
+                    }
+                    else {
+                        row[x] = flat;
+                    }
+                }
+                flushPhong(xs, y, row, face.color);
+            }
+        };
+
+        auto toCoverage = [](double c) {
+            return static_cast<uint>(min(fabs(c), 1.0) * 256 + 0.5);
+        };
+
+        // between two cells the coverage is constant, only partly covered pixels blend
+        auto fillRun = [&](int x, int end, double acc) {
+            auto a = toCoverage(acc);
+            if (a >= 256)
+                fillCovered(x, end);
+            else if (a > 0)
+                for (; x < end; x++)
+                    paint(x, a);
+        };
+
+        double acc = 0;
+        int x = 0;
+        for (auto& cell : coverage.Row(y, width)) {
+            fillRun(x, cell.x, acc);
+
+            if (cell.x >= 0) {
+                auto ca = toCoverage(acc + static_cast<double>(cell.area));
+                if (ca > 0) { paint(cell.x, ca); }
+            }
+
+            acc += static_cast<double>(cell.cover);
+            x = cell.x + 1;
+        }
+
+        // the cells right of the target are dropped, a face crossing it covers the row to its end
+        fillRun(x, width, acc);
+    }
+}
+
+// ==================================================================================================
+// A face too thin to reach a row center has no edge in the ET, its one ramp runs from its
+// leftmost corner to its rightmost one.
+PolygonRenderer::SpanRamp PolygonRenderer::sliverRamp(const Mesh& mesh, const Face& face) {
+    auto cornerX = [&](uint32_t c) { return mesh.points[mesh.indices[c]].x(); };
+    uint32_t left = face.first, right = face.first;
+    mesh.ForEachEdgeCorners(face, [&](uint32_t c, uint32_t) {
+        if (cornerX(c) < cornerX(left)) { left = c; }
+        if (cornerX(c) > cornerX(right)) { right = c; }
+    });
+
+    SpanRamp ramp;
+    auto corner = [&](uint32_t c, double& x, double& q, double& z,
+                      double& r, double& g, double& b, QVector3D& n, double& u, double& v) {
+        auto i = mesh.indices[c];
+        q = mesh.weights[i];
+        x = mesh.points[i].x();
+        z = mesh.points[i].z() * q;
+        if (face.texture != nullptr) {
+            u = mesh.uvs[c].x() * q;
+            v = mesh.uvs[c].y() * q;
+        }
+        else if (shading == Shading::GOURAUD) {
+            auto color = litColor(vertexDiffuse[i], vertexSpecular[i], face.color);
+            r = color.red() * q;
+            g = color.green() * q;
+            b = color.blue() * q;
+        }
+        else if (shading == Shading::PHONG) {
+            n = mesh.normals[i] * static_cast<float>(q);
+        }
+    };
+    corner(left, ramp.x0, ramp.q0, ramp.z0, ramp.r0, ramp.g0, ramp.b0, ramp.n0, ramp.u0, ramp.v0);
+    corner(right, ramp.x1, ramp.q1, ramp.z1, ramp.r1, ramp.g1, ramp.b1, ramp.n1, ramp.u1, ramp.v1);
+    return ramp;
+}
@@ -0,0 +1,293 @@
+#ifndef POLYGONRENDERER_H
+#define POLYGONRENDERER_H
+
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <list>
+#include "qcolor.h"
+#include "qpoint.h"
+#include "qpainter.h"
+
+#include "blocoet.h"
+#include "lightset.h"
+#include "camera.h"
+#include "framebuffer.h"
+#include "renderstats.h"
+#include "mesh.h"
+#include "scene.h"
+#include "edgecoverage.h"
+#include "spanstepper.h"
+#include "scanlinevisibility.h"
+#include "spanbuffer.h"
+#include "abuffer.h"
+#include "shadowmap.h"
+#include "texture.h"
+#include "outlinelod.h"
+#include "overdrawcounters.h"
+
+#include <map>
+#include <vector>
+
+using namespace std;
+
+// The scanline engine: extrudes the edited polygon and the scene, runs the geometry stage and
+// fills every face into a FrameBuffer. Nothing here knows about widgets, PolygonDrawer puts it
+// on the canvas and the batch renderer runs one per thread.
+class PolygonRenderer
+{
+public:
+    enum Shading {
+        FLAT,
+        GOURAUD,
+        PHONG
+    };
+
+    // Faces whose color has an alpha below 255 are blended order independently (see ABuffer)
+    // against the depth buffer; SCANLINE and SBUFFER keep none and draw them opaque.
+    enum Visibility {
+        ZBUFFER,
+        SCANLINE,   // global AET, no depth buffer (FLAT without anti-aliasing only)
+        SBUFFER     // per row span buffer (FLAT and GOURAUD without anti-aliasing only)
+    };
+
+    // debug views replacing the shaded image by the work done on every pixel
+    enum Heatmap {
+        NONE,
+        DEPTH_TESTS,
+        WRITES,
+        SHADING_COST
+    };
+
+    vector<QPoint*> Vertices;
+
+private:
+    LightSet* lights;
+    Camera* camera;
+    Shading shading;
+    Visibility visibility = Visibility::ZBUFFER;
+    Heatmap heatmap = Heatmap::NONE;
+    float extrusion = 50;
+    static const int GUARD_BAND = 64;   // pixels around the frame a face may reach unclipped
+    double cteAmb = 0.2;
+    double cteDiff = 2.9;
+    double cteSpec = 0.3;
+    double shininess = 3;
+
+    Scene* scene = nullptr;
+    const Texture* texture = nullptr;
+    bool antiAliasing = false;
+    float lodTolerance = 0.5f;  // pixels, 0 extrudes every vertex
+    bool shadows = false;
+    int shadowFilter = 1;       // PCF radius in texels, 0 for a single lookup
+    static const int SHADOW_MAP_SIZE = 1024;
+
+    RenderStats stats;
+    // contour of a polygon once extruded into the mesh
+    struct ExtrudedLoop {
+        uint32_t base;
+        uint32_t first;     // of the contour in the source coordinates
+        uint32_t n;
+        bool reversed;
+
+        uint32_t Front(uint32_t i) const { return base + (reversed ? n - 1 - i : i); }
+        uint32_t Back(uint32_t i) const { return base + n + (reversed ? n - 1 - i : i); }
+    };
+
+    // Edges of the face being filled, row by row, in x order and paired into spans. A convex face
+    // has a single span per row between its left and right chains, which are walked directly one
+    // edge each, with no edge table and no sorting; any other face goes through the odd-even
+    // ET/AET. Kept between faces so the walk does not allocate.
+    struct FaceEdges {
+        vector<BlocoET> et;     // by first row
+        size_t next;            // first edge of the ET not in the AET yet
+        vector<BlocoET> aet;
+        vector<BlocoET> chains; // left and right edge of a convex face
+        uint32_t corner[2];     // corner the edge of each chain ends at
+        uint32_t step[2];       // to the next corner of each chain, modulo the loop
+        uint32_t bottom;        // corner where both chains end
+        bool convex;
+        bool done;
+    };
+
+    // depth and shading ramps of one span of the AET, between its two edges,
+    // premultiplied by the perspective weights q0, q1 like the AET itself
+    struct SpanRamp {
+        double x0, x1;
+        double q0, q1;
+        double z0, z1;
+        double r0, g0, b0, r1, g1, b1;
+        QVector3D n0, n1;
+        double u0, v0, u1, v1;
+        int level;          // mip level of a textured face, from the footprint along the span
+    };
+
+    Mesh mesh;                  // reused every frame, only its capacity survives
+    vector<float> outline;
+    vector<ExtrudedLoop> loops;
+    vector<float> wallU;
+
+    // simplification hierarchies, rebuilt when the edited outline or the scene geometry changes
+    OutlineLod outlineLod;
+    OutlineLod sceneLod;
+    vector<float> lodOutline;
+    const Scene* lodScene = nullptr;
+    uint64_t lodRevision = 0;
+    vector<float> lodCoords;
+    vector<uint32_t> lodContours;
+    // shadow map of the first light, rebuilt when the geometry or the light changes
+    ShadowMap shadowMap;
+    bool shadowBuilt = false;
+    vector<float> shadowOutline;
+    const Scene* shadowScene = nullptr;
+    uint64_t shadowRevision = 0;
+    float shadowExtrusion = 0;
+    float shadowLodTolerance = 0;
+    LightSource::Type shadowLightType = LightSource::Type::POINT;
+    QVector3D shadowLight;
+    QMatrix4x4 viewToWorld;     // of the frame, with its projection for the shadow lookups
+    Projection frameProjection;
+
+    EdgeCoverage coverage;
+    ScanlineVisibility scanline;
+    SpanBuffer spanBuffer;
+    bool spanBuffered = false;  // the opaque faces of this frame go through spanBuffer
+    ABuffer aBuffer;
+    vector<SpanRamp> ramps;
+
+    OverdrawCounters overdraw;
+    OverdrawCounters* counters = nullptr;   // &overdraw while a heatmap is shown
+
+    FaceEdges faceEdges;
+    vector<QRgb> faceColors;    // FLAT color of every face, for the scanline visibility and S-buffer
+
+    LightBatch batch;
+    vector<QVector3D> vertexDiffuse;    // GOURAUD lighting of every mesh vertex
+    vector<QVector3D> vertexSpecular;
+
+public:
+    PolygonRenderer(LightSet* lights, Camera* camera);
+    virtual ~PolygonRenderer();
+
+    // Rasterizes the polygon into an arbitrary target
+    void Render(FrameBuffer& target, QColor paintColor);
+    const RenderStats& Stats() const;
+
+    void SetShading(Shading);
+
+    // Extra polygons drawn in the same pass and depth buffer as Vertices (not owned)
+    void SetScene(Scene*);
+
+    // Blends edge pixels by their exact area coverage instead of the ceil(x) spans
+    void SetAntiAliasing(bool);
+
+    void SetVisibility(Visibility);
+
+    // Maps the texture over the faces of the edited polygon, nullptr paints them with the color (not owned)
+    void SetTexture(const Texture*);
+
+    // Drops the outline vertices whose removal moves the silhouette by less than about this many
+    // pixels on screen (Visvalingam-Whyatt area), 0 extrudes every vertex
+    void SetLodTolerance(float pixels);
+
+    // Counts the depth tests, writes and lighting of every pixel, shows one of them as a false
+    // color image and fills the overdraw counters of the stats
+    void SetHeatmap(Heatmap);
+    Heatmap GetHeatmap() const;
+
+    // Shadows of the first light on GOURAUD (per vertex) and PHONG (per pixel) shading, from a
+    // shadow map rendered from the light; FLAT shading is not lit by the lights and has none
+    void SetShadows(bool);
+
+    // Percentage-closer filter radius of the shadow lookups in texels, 0 takes a single texel
+    void SetShadowFilter(int radius);
+
+protected:
+    // called when a setting changes the image
+    virtual void changed();
+
+private:
+    void renderFrame(FrameBuffer& target, QColor paintColor);
+
+    void oddEvenFillMethodFLAT(const Mesh& mesh,
+                           const Face& face,
+                           FrameBuffer& frame);
+
+    void oddEvenFillMethodGOURAULD(const Mesh& mesh,
+                           const Face& face,
+                           FrameBuffer& frame);
+
+    void oddEvenFillMethodPHONG(const Mesh& mesh,
+                           const Face& face,
+                           FrameBuffer& frame);
+
+    void oddEvenFillMethodTEXTURE(const Mesh& mesh,
+                           const Face& face,
+                           FrameBuffer& frame);
+
+    void antiAliasedFill(const Mesh& mesh,
+                         const Face& face,
+                         FrameBuffer& frame);
+    SpanRamp sliverRamp(const Mesh& mesh, const Face& face);
+
+    void translucentFill(const Mesh& mesh,
+                         const Face& face,
+                         FrameBuffer& frame);
+
+    void scanlineFill(const Mesh& mesh, FrameBuffer& frame);
+    void emitSpanBuffer(FrameBuffer& frame);
+    void resolveTranslucency(FrameBuffer& frame);
+    void showHeatmap(FrameBuffer& frame);
+
+    // SCAN LINE HELPERS
+    inline bool testDepth(FrameBuffer& frame, int x, int y, double z) {
+        bool pass = frame.Depth(x, y) > z;
+        if (counters != nullptr) { counters->Test(x, y, pass); }
+        return pass;
+    }
+    // textures replace the color, so only untextured faces take its opacity
+    static inline bool isTranslucent(const Face& face) {
+        return face.color.alpha() < 255 && face.texture == nullptr;
+    }
+    void prepareEt(const Mesh& mesh, const Face& face, vector<BlocoET>& et);
+    void updateAET (int y, vector<BlocoET>& aet, const vector<BlocoET>& et, size_t& next);
+    BlocoET makeEdge(const Mesh& mesh, const Face& face, uint32_t ca, uint32_t cb);
+    int beginEdges(const Mesh& mesh, const Face& face);
+    vector<BlocoET>* activeEdges(const Mesh& mesh, const Face& face, int y);
+    bool monotoneChains(const Mesh& mesh, const Face& face, uint32_t top, uint32_t bottom) const;
+    bool advanceChain(const Mesh& mesh, const Face& face, int chain);
+
+    // Shading
+    QColor shade(QVector3D p, QVector3D normal, const QColor& paintColor);
+    QColor litColor(const QVector3D& diffuse, const QVector3D& specular, const QColor& paintColor);
+    QColor litColor(const LightBatch& batch, size_t i, const QColor& paintColor);
+    void lightVertices(const Mesh& mesh);
+    void updateShadowMap(const Mesh& mesh);
+    void shadowBatch(LightBatch& batch);
+    void flushPhong(const int* xs, int y, QRgb* row, const QColor& paintColor);
+    QColor flatColor(QVector3D& n, const QColor& c);
+
+    // Geometry Helpers
+    // extrudes every polygon into the mesh and moves all of it to screen space
+    void preparePoints(Mesh& mesh, QColor paintColor, int width, int height);
+    void clipDepth(Mesh& mesh, const Projection& projection);
+    void clipViewport(Mesh& mesh, int width, int height);
+    void appendExtrusion(Mesh& mesh, const float* coords, const uint32_t* contours,
+                         size_t contourCount, float extrusion,
+                         const QColor& color, const QMatrix4x4& transform,
+                         const Texture* texture, bool convex);
+    void appendLevel(Mesh& mesh, const OutlineLod& lod, const float* coords, const uint32_t* contours,
+                     size_t first, size_t count, float extrusion,
+                     const QColor& color, const QMatrix4x4& transform,
+                     const QMatrix4x4& view, const Projection& projection,
+                     const Texture* texture);
+    void appendModel(Mesh& mesh, const Model& model);
+    float lodArea(const float* bounds, float extrusion, const QMatrix4x4& toView,
+                  const Projection& projection) const;
+
+    void printScanLine(int xbeg, int xend, QColor& cbeg, QColor& cend, QPainter& painter);
+};
+
+
+
+#endif // POLYGONRENDERER_H
@@ -0,0 +1,34 @@
+#ifndef RENDERSTATS_H
+#define RENDERSTATS_H
+
+#include <QtGlobal>
+#include "alloctracker.h"
+
+// Counters filled by one call to PolygonRenderer::Render
+struct RenderStats {
+    qint64 nsecs = 0;       // wall time spent in Render
+    size_t faces = 0;       // faces submitted to the fill
+    size_t culled = 0;      // faces rejected outside the viewport
+    size_t clipped = 0;     // faces clipped to the guard band
+    size_t convex = 0;      // faces filled by the two-edge walk instead of the edge table
+    size_t translucent = 0; // faces blended through the A-buffer
+    size_t fragments = 0;   // translucent fragments blended in front of the opaque pixels
+    size_t shadowMaps = 0;  // shadow maps rendered, 0 while the cached one is still valid
+    size_t vertices = 0;    // outline vertices extruded, after the level of detail
+    size_t dropped = 0;     // outline vertices left out by the level of detail
+
+    // only counted while a heatmap is shown
+    size_t depthPassed = 0;
+    size_t depthFailed = 0;
+    size_t writes = 0;      // pixel writes, overdraw is writes / covered
+    size_t covered = 0;     // pixels written at least once
+    size_t shades = 0;      // lighting evaluations per pixel and light (PHONG)
+
+    // heap use of the frame, only counted with CONFIG+=alloctracking (see AllocTracker)
+    size_t allocations = 0;
+    size_t allocatedBytes = 0;
+    size_t peakBytes = 0;   // largest growth of the heap during the frame
+    size_t stageAllocations[AllocTracker::STAGE_COUNT] = {};
+};
+
+#endif // RENDERSTATS_H
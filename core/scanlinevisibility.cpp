@@ -0,0 +1,176 @@
+#include "scanlinevisibility.h"
+#include "cgutils.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+void ScanlineVisibility::Resolve(const Mesh& mesh, int width, int height, bool perspective) {
+    spans.clear();
+    aet.clear();
+    active.clear();
+    if (width <= 0 || height <= 0) { return; }
+
+    et.resize(static_cast<size_t>(height));
+    for (auto& bucket : et)
+        bucket.clear();
+
+    auto faceCount = mesh.faces.size();
+    planes.resize(faceCount);
+    inside.assign(faceCount, 0);
+
+    // global edge table, same sampling as PolygonRenderer::prepareEt
+    for (uint32_t f = 0; f < faceCount; f++) {
+        auto& face = mesh.faces[f];
+        if (face.count < 3 || !fitPlane(mesh, face, perspective, planes[f])) { continue; }
+
+        mesh.ForEachEdge(face, [&](uint32_t ia, uint32_t ib) {
+            auto a = &mesh.points[ia];
+            auto b = &mesh.points[ib];
+            if (CGUtils::FirstSample(a->y()) == CGUtils::FirstSample(b->y())) { return; }
+            if (a->y() > b->y()) { std::swap(a, b); }
+
+            int ymin = CGUtils::FirstSample(a->y());
+            int ymax = CGUtils::FirstSample(b->y());
+            if (ymax <= 0 || ymin >= height) { return; }
+
+            Edge e;
+            e.ymax = ymax;
+            e.dx = (static_cast<double>(b->x()) - a->x()) / (static_cast<double>(b->y()) - a->y());
+            e.x = a->x() + (ymin + 0.5 - a->y()) * e.dx;
+            e.face = f;
+
+            // rows above the frame are skipped in one step
+            if (ymin < 0) {
+                e.x += e.dx * -ymin;
+                ymin = 0;
+            }
+            et[static_cast<size_t>(ymin)].push_back(e);
+        });
+    }
+
+    for (int y = 0; y < height; y++) {
+        aet.erase(std::remove_if(aet.begin(), aet.end(), [y](const Edge& e) { return e.ymax == y; }),
+                  aet.end());
+        auto& bucket = et[static_cast<size_t>(y)];
+        aet.insert(aet.end(), bucket.begin(), bucket.end());
+        if (aet.empty()) { continue; }
+
+        // nearly sorted from the previous row
+        for (size_t i = 1; i < aet.size(); i++)
+            for (size_t j = i; j > 0 && aet[j].x < aet[j-1].x; j--)
+                std::swap(aet[j], aet[j-1]);
+
+        // between two crossings the faces under the row do not change
+        for (size_t i = 0; i < aet.size(); i++) {
+            auto face = aet[i].face;
+            inside[face] = !inside[face];
+            if (inside[face])
+                active.push_back(face);
+            else
+                active.erase(std::find(active.begin(), active.end(), face));
+
+            if (active.empty() || i + 1 == aet.size()) { continue; }
+
+            auto x0 = std::max(CGUtils::FirstSample(aet[i].x), 0);
+            auto x1 = std::min(CGUtils::FirstSample(aet[i+1].x), width) - 1;
+            if (x0 <= x1)
+                resolveInterval(y, x0, x1);
+        }
+
+        for (auto& e : aet)
+            e.x += e.dx;
+    }
+}
+
+// ==================================================================================================
+const std::vector<ScanlineVisibility::Span>& ScanlineVisibility::Spans() const {
+    return spans;
+}
+
+// ==================================================================================================
+// PRIVATE MEMBERS
+// ==================================================================================================
+// Newell's plane of the outline in (x, y, key) space, false for a face seen edge-on
+bool ScanlineVisibility::fitPlane(const Mesh& mesh, const Face& face, bool perspective, Plane& plane) const {
+    auto end = mesh.loopEnds[face.loop] - face.first;
+    auto key = [&](uint32_t k) {
+        return perspective ? -static_cast<double>(mesh.weights[mesh.Index(face, k)])
+                           : static_cast<double>(mesh.Point(face, k).z());
+    };
+
+    double nx = 0, ny = 0, nk = 0;
+    double cx = 0, cy = 0, ck = 0;
+    for (uint32_t i = 0; i < end; i++) {
+        auto j = i + 1 < end ? i + 1 : 0;
+        auto& pi = mesh.Point(face, i);
+        auto& pj = mesh.Point(face, j);
+        auto ki = key(i);
+        auto kj = key(j);
+
+        nx += (static_cast<double>(pi.y()) - pj.y()) * (ki + kj);
+        ny += (ki - kj) * (static_cast<double>(pi.x()) + pj.x());
+        nk += (static_cast<double>(pi.x()) - pj.x()) * (static_cast<double>(pi.y()) + pj.y());
+        cx += pi.x();
+        cy += pi.y();
+        ck += ki;
+    }
+    if (fabs(nk) < 1e-9) { return false; }
+
+    cx /= end;
+    cy /= end;
+    ck /= end;
+    plane.a = -nx / nk;
+    plane.b = -ny / nk;
+    plane.c = ck - plane.a * cx - plane.b * cy;
+    return true;
+}
+
+// ==================================================================================================
+// pixels x0..x1 of row y under the active faces
+void ScanlineVisibility::resolveInterval(int y, int x0, int x1) {
+    auto left = nearest(x0, y);
+    auto right = x1 > x0 ? nearest(x1, y) : left;
+
+    if (left == right) {
+        // both ends are won by the same plane, so is everything between (planes are lines here)
+        if (!spans.empty()) {
+            auto& last = spans.back();
+            if (last.face == left && last.y == y && last.x1 + 1 == x0) {
+                last.x1 = x1;
+                return;
+            }
+        }
+        spans.push_back({left, y, x0, x1});
+        return;
+    }
+
+    // split where the two winners cross
+    auto& pl = planes[left];
+    auto& pr = planes[right];
+    auto slope = pl.a - pr.a;
+    auto cross = slope != 0 ? ((pr.b - pl.b) * y + pr.c - pl.c) / slope : (x0 + x1) / 2.0;
+    auto split = static_cast<int>(floor(cross));
+    split = std::min(std::max(split, x0), x1 - 1);
+
+    resolveInterval(y, x0, split);
+    resolveInterval(y, split + 1, x1);
+}
+
+// ==================================================================================================
+// nearest active face at a pixel, ties go to the first face like the depth test of the fills
+uint32_t ScanlineVisibility::nearest(double x, double y) const {
+    auto best = active.front();
+    auto bestKey = planes[best].At(x, y);
+    for (size_t i = 1; i < active.size(); i++) {
+        auto f = active[i];
+        auto k = planes[f].At(x, y);
+        if (k < bestKey || (k == bestKey && f < best)) {
+            best = f;
+            bestKey = k;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,58 @@
+#ifndef SCANLINEVISIBILITY_H
+#define SCANLINEVISIBILITY_H
+
+#include <vector>
+#include <cstdint>
+#include "mesh.h"
+
+// Watkins-style visibility, an alternative to the depth buffer.
+// One edge table holds the edges of every face of the mesh, tagged with their face. Each
+// scanline is cut at the edge crossings into intervals under which the set of faces does not
+// change (odd-even per face, so holes work), and each interval is resolved by comparing the
+// depth planes of those faces at its two ends: a plane winning at both ends wins everywhere in
+// between, otherwise the interval is split where the two winners cross. Every pixel comes out
+// of exactly one visible span, there is no depth memory and no overdraw.
+class ScanlineVisibility
+{
+public:
+    struct Span {
+        uint32_t face;
+        int y;
+        int x0, x1;     // inclusive
+    };
+
+private:
+    struct Edge {
+        int ymax;
+        double x, dx;
+        uint32_t face;
+    };
+
+    // depth key of a face over the screen, smaller is nearer
+    struct Plane {
+        double a, b, c;
+        double At(double x, double y) const { return a * x + b * y + c; }
+    };
+
+    std::vector<std::vector<Edge>> et;
+    std::vector<Edge> aet;
+    std::vector<Plane> planes;
+    std::vector<char> inside;
+    std::vector<uint32_t> active;
+    std::vector<Span> spans;
+
+public:
+    // Mesh points must be in screen space. With perspective the depth key is -q (1/w is affine
+    // over the screen), otherwise it is the depth itself.
+    void Resolve(const Mesh& mesh, int width, int height, bool perspective);
+
+    // visible spans of the last Resolve, by row then x
+    const std::vector<Span>& Spans() const;
+
+private:
+    bool fitPlane(const Mesh& mesh, const Face& face, bool perspective, Plane& plane) const;
+    void resolveInterval(int y, int x0, int x1);
+    uint32_t nearest(double x, double y) const;
+};
+
+#endif // SCANLINEVISIBILITY_H
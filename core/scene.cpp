@@ -0,0 +1,152 @@
+#include "scene.h"
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+Scene::Scene() {
+    Clear();
+}
+
+// ==================================================================================================
+size_t Scene::AddPolygon(const std::vector<QPointF>& outline, QColor color,
+                         float extrusion, const QMatrix4x4& transform) {
+    return AddPolygon(std::vector<std::vector<QPointF>>{ outline }, color, extrusion, transform);
+}
+
+// ==================================================================================================
+size_t Scene::AddPolygon(const std::vector<std::vector<QPointF>>& contours, QColor color,
+                         float extrusion, const QMatrix4x4& transform) {
+    detach();
+
+    Polygon polygon;
+    polygon.firstContour = contourCount;
+    polygon.contourCount = contours.size();
+    polygon.color = color;
+    polygon.extrusion = extrusion;
+    polygon.transform = transform;
+
+    for (auto& contour : contours) {
+        for (auto& p : contour) {
+            coords.push_back(static_cast<float>(p.x()));
+            coords.push_back(static_cast<float>(p.y()));
+        }
+        this->contours.push_back(static_cast<uint32_t>(coords.size() / 2));
+    }
+
+    coordData = coords.data();
+    contourData = this->contours.data();
+    vertexCount = coords.size() / 2;
+    contourCount = this->contours.size() - 1;
+
+    polygons.push_back(polygon);
+    revision++;
+    return polygons.size() - 1;
+}
+
+// ==================================================================================================
+size_t Scene::AddModel(std::unique_ptr<Model> model) {
+    models.push_back(std::move(model));
+    revision++;
+    return models.size() - 1;
+}
+
+// ==================================================================================================
+void Scene::Clear() {
+    mapping.reset();
+    coords.clear();
+    contours.assign(1, 0);
+    polygons.clear();
+    models.clear();
+
+    coordData = coords.data();
+    contourData = contours.data();
+    vertexCount = 0;
+    contourCount = 0;
+    revision++;
+}
+
+// ==================================================================================================
+size_t Scene::Size() const {
+    return polygons.size();
+}
+
+// ==================================================================================================
+size_t Scene::VertexCount() const {
+    return vertexCount;
+}
+
+// ==================================================================================================
+size_t Scene::ContourCount() const {
+    return contourCount;
+}
+
+// ==================================================================================================
+const Scene::Polygon& Scene::At(size_t i) const {
+    return polygons[i];
+}
+
+// ==================================================================================================
+Scene::Polygon& Scene::At(size_t i) {
+    return polygons[i];
+}
+
+// ==================================================================================================
+size_t Scene::ModelCount() const {
+    return models.size();
+}
+
+// ==================================================================================================
+const Model& Scene::ModelAt(size_t i) const {
+    return *models[i];
+}
+
+// ==================================================================================================
+const float* Scene::Vertices() const {
+    return coordData;
+}
+
+// ==================================================================================================
+const uint32_t* Scene::Contours() const {
+    return contourData;
+}
+
+// ==================================================================================================
+bool Scene::IsMapped() const {
+    return mapping != nullptr;
+}
+
+// ==================================================================================================
+uint64_t Scene::Revision() const {
+    return revision;
+}
+
+// ==================================================================================================
+void Scene::AttachMapping(std::unique_ptr<QFile> file,
+                          const float* coords, size_t vertexCount,
+                          const uint32_t* contours, size_t contourCount,
+                          std::vector<Polygon>&& polygons) {
+    Clear();
+    mapping = std::move(file);
+
+    this->coordData = coords;
+    this->contourData = contours;
+    this->vertexCount = vertexCount;
+    this->contourCount = contourCount;
+    this->polygons = std::move(polygons);
+    revision++;
+}
+
+// ==================================================================================================
+// PRIVATE MEMBERS
+// ==================================================================================================
+// copies the mapped arrays into owned storage before the scene is modified
+void Scene::detach() {
+    if (mapping == nullptr) { return; }
+
+    coords.assign(coordData, coordData + 2 * vertexCount);
+    contours.assign(contourData, contourData + contourCount + 1);
+    mapping.reset();
+
+    coordData = coords.data();
+    contourData = contours.data();
+}
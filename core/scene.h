@@ -0,0 +1,88 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <QColor>
+#include <QPointF>
+#include <QMatrix4x4>
+#include <QFile>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "model.h"
+
+// A set of extruded polygons rendered together by PolygonRenderer.
+// Vertices of all polygons live in one contiguous x,y float array and are split in contours
+// by an offset table (contour c spans vertices [Contours()[c], Contours()[c+1]) ).
+// A polygon is a range of contours: the first is its outline, the others are holes.
+// Both arrays may point straight into a memory mapped scene file (see SceneIO), in which case
+// they are read in place and only copied if the scene is edited.
+// Meshes loaded by ModelIO are drawn along with the polygons; they are not saved in scene files.
+class Scene
+{
+public:
+    struct Polygon {
+        size_t firstContour;
+        size_t contourCount;
+        QColor color;
+        float extrusion;        // half depth, the caps sit at -extrusion and +extrusion
+        QMatrix4x4 transform;   // model transform applied before the camera
+    };
+
+private:
+    std::vector<float> coords;
+    std::vector<uint32_t> contours;
+    std::vector<Polygon> polygons;
+    std::vector<std::unique_ptr<Model>> models;
+
+    // views used by the renderer, either over the vectors above or over the mapping
+    const float* coordData;
+    const uint32_t* contourData;
+    size_t vertexCount = 0;
+    size_t contourCount = 0;
+    uint64_t revision = 0;
+
+    std::unique_ptr<QFile> mapping;
+
+public:
+    Scene();
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+
+    size_t AddPolygon(const std::vector<QPointF>& outline, QColor color,
+                      float extrusion = 50, const QMatrix4x4& transform = QMatrix4x4());
+    size_t AddPolygon(const std::vector<std::vector<QPointF>>& contours, QColor color,
+                      float extrusion = 50, const QMatrix4x4& transform = QMatrix4x4());
+    size_t AddModel(std::unique_ptr<Model> model);
+    void Clear();
+
+    size_t Size() const;
+    size_t VertexCount() const;
+    size_t ContourCount() const;
+
+    const Polygon& At(size_t i) const;
+    Polygon& At(size_t i);
+
+    size_t ModelCount() const;
+    const Model& ModelAt(size_t i) const;
+
+    // x,y pairs of every vertex of the scene
+    const float* Vertices() const;
+    // contour start offsets, ContourCount() + 1 entries (the last one is VertexCount())
+    const uint32_t* Contours() const;
+
+    bool IsMapped() const;
+
+    // changes whenever vertices, contours or models are added or replaced
+    uint64_t Revision() const;
+
+    // takes over a mapped file whose arrays are used in place (used by SceneIO)
+    void AttachMapping(std::unique_ptr<QFile> file,
+                       const float* coords, size_t vertexCount,
+                       const uint32_t* contours, size_t contourCount,
+                       std::vector<Polygon>&& polygons);
+
+private:
+    void detach();
+};
+
+#endif // SCENE_H
@@ -0,0 +1,244 @@
+#include "sceneio.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <cstring>
+
+// ==================================================================================================
+#define SECTION_ALIGN 16
+
+static uint64_t align(uint64_t offset) {
+    return (offset + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+}
+
+static bool fail(QString* error, const QString& message) {
+    if (error != nullptr) { *error = message; }
+    return false;
+}
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+bool SceneIO::Load(const QString& path, Scene& scene, QString* error) {
+    return isBinary(path) ? LoadBinary(path, scene, error) : LoadText(path, scene, error);
+}
+
+// ==================================================================================================
+bool SceneIO::Save(const QString& path, const Scene& scene, QString* error) {
+    return isBinary(path) ? SaveBinary(path, scene, error) : SaveText(path, scene, error);
+}
+
+// ==================================================================================================
+bool SceneIO::LoadBinary(const QString& path, Scene& scene, QString* error) {
+    std::unique_ptr<QFile> file(new QFile(path));
+    if (!file->open(QFile::ReadOnly))
+        return fail(error, file->errorString());
+
+    auto size = static_cast<uint64_t>(file->size());
+    if (size < sizeof(SceneFileHeader))
+        return fail(error, "not a scene file");
+
+    auto data = file->map(0, file->size());
+    if (data == nullptr)
+        return fail(error, file->errorString());
+
+    SceneFileHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, "PSLS", 4) != 0)
+        return fail(error, "not a scene file");
+    if (header.version != VERSION)
+        return fail(error, QString("unsupported scene version %1").arg(header.version));
+
+    auto fits = [size](uint64_t offset, uint64_t count, uint64_t stride) {
+        return offset % SECTION_ALIGN == 0 && offset <= size && count <= (size - offset) / stride;
+    };
+    // the contour count is bounded first, so the extra end offset cannot wrap it around
+    if (header.vertexCount > UINT32_MAX || header.contourCount >= UINT32_MAX
+            || !fits(header.vertexOffset, header.vertexCount, 2 * sizeof(float))
+            || !fits(header.contourOffset, header.contourCount + 1, sizeof(uint32_t))
+            || !fits(header.polygonOffset, header.polygonCount, sizeof(SceneFilePolygon)))
+        return fail(error, "truncated scene file");
+
+    auto coords = reinterpret_cast<const float*>(data + header.vertexOffset);
+    auto contours = reinterpret_cast<const uint32_t*>(data + header.contourOffset);
+
+    // the offsets are trusted by the renderer, so they are the one array worth checking
+    if (contours[0] != 0 || contours[header.contourCount] != header.vertexCount)
+        return fail(error, "corrupt contour table");
+    for (uint64_t c = 0; c < header.contourCount; c++)
+        if (contours[c] > contours[c + 1])
+            return fail(error, "corrupt contour table");
+
+    std::vector<Scene::Polygon> polygons(static_cast<size_t>(header.polygonCount));
+    auto records = data + header.polygonOffset;
+    for (size_t i = 0; i < polygons.size(); i++) {
+        SceneFilePolygon record;
+        memcpy(&record, records + i * sizeof(record), sizeof(record));
+        if (static_cast<uint64_t>(record.firstContour) + record.contourCount > header.contourCount)
+            return fail(error, "corrupt polygon table");
+
+        auto& polygon = polygons[i];
+        polygon.firstContour = record.firstContour;
+        polygon.contourCount = record.contourCount;
+        polygon.color = QColor::fromRgba(record.color);
+        polygon.extrusion = record.extrusion;
+        polygon.transform = QMatrix4x4(record.transform).transposed();
+    }
+
+    scene.AttachMapping(std::move(file), coords, static_cast<size_t>(header.vertexCount),
+                        contours, static_cast<size_t>(header.contourCount), std::move(polygons));
+    return true;
+}
+
+// ==================================================================================================
+bool SceneIO::SaveBinary(const QString& path, const Scene& scene, QString* error) {
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        return fail(error, file.errorString());
+
+    SceneFileHeader header;
+    memcpy(header.magic, "PSLS", 4);
+    header.version = VERSION;
+    header.headerSize = sizeof(SceneFileHeader);
+    header.flags = 0;
+    header.vertexCount = scene.VertexCount();
+    header.contourCount = scene.ContourCount();
+    header.polygonCount = scene.Size();
+    header.vertexOffset = align(sizeof(SceneFileHeader));
+    header.contourOffset = align(header.vertexOffset + header.vertexCount * 2 * sizeof(float));
+    header.polygonOffset = align(header.contourOffset + (header.contourCount + 1) * sizeof(uint32_t));
+
+    const char padding[SECTION_ALIGN] = {};
+    auto section = [&file, &padding](uint64_t offset, const void* data, uint64_t bytes) {
+        auto pad = offset - static_cast<uint64_t>(file.pos());
+        return file.write(padding, static_cast<qint64>(pad)) == static_cast<qint64>(pad)
+            && file.write(static_cast<const char*>(data), static_cast<qint64>(bytes)) == static_cast<qint64>(bytes);
+    };
+
+    bool ok = file.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header)
+        && section(header.vertexOffset, scene.Vertices(), header.vertexCount * 2 * sizeof(float))
+        && section(header.contourOffset, scene.Contours(), (header.contourCount + 1) * sizeof(uint32_t));
+
+    std::vector<SceneFilePolygon> records(scene.Size());
+    for (size_t i = 0; i < scene.Size(); i++) {
+        auto& polygon = scene.At(i);
+        auto& record = records[i];
+        record.firstContour = static_cast<uint32_t>(polygon.firstContour);
+        record.contourCount = static_cast<uint32_t>(polygon.contourCount);
+        record.color = polygon.color.rgba();
+        record.extrusion = polygon.extrusion;
+        memcpy(record.transform, polygon.transform.constData(), sizeof(record.transform));
+    }
+    ok = ok && section(header.polygonOffset, records.data(), records.size() * sizeof(SceneFilePolygon));
+
+    return ok ? true : fail(error, file.errorString());
+}
+
+// ==================================================================================================
+bool SceneIO::LoadText(const QString& path, Scene& scene, QString* error) {
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+        return fail(error, file.errorString());
+
+    QTextStream in(&file);
+    auto header = in.readLine().simplified().split(' ');
+    if (header.size() != 2 || header[0] != "pslscene" || header[1].toUInt() != VERSION)
+        return fail(error, "not a scene file");
+
+    scene.Clear();
+
+    std::vector<std::vector<QPointF>> contours;
+    QColor color;
+    float extrusion = 0;
+    QMatrix4x4 transform;
+    bool open = false;
+
+    auto flush = [&]() {
+        if (open && !contours.empty())
+            scene.AddPolygon(contours, color, extrusion, transform);
+        contours.clear();
+    };
+
+    for (int line = 2; !in.atEnd(); line++) {
+        auto fields = in.readLine().simplified().split(' ');
+        if (fields[0].isEmpty() || fields[0].startsWith('#')) { continue; }
+
+        bool ok = true;
+        if (fields[0] == "polygon" && (fields.size() == 3 || fields.size() == 19)) {
+            flush();
+            open = true;
+            color = QColor(fields[1]);
+            extrusion = fields[2].toFloat(&ok);
+
+            float m[16];
+            for (int i = 0; ok && i < 16 && fields.size() == 19; i++)
+                m[i] = fields[3 + i].toFloat(&ok);
+            transform = fields.size() == 19 ? QMatrix4x4(m).transposed() : QMatrix4x4();
+            ok = ok && color.isValid();
+        }
+        else if (fields[0] == "contour" && open && fields.size() % 2 == 1) {
+            std::vector<QPointF> contour;
+            contour.reserve(static_cast<size_t>(fields.size() / 2));
+            for (int i = 1; ok && i + 1 < fields.size(); i += 2) {
+                bool okY = true;
+                contour.push_back(QPointF(fields[i].toDouble(&ok), fields[i + 1].toDouble(&okY)));
+                ok = ok && okY;
+            }
+            contours.push_back(contour);
+        }
+        else {
+            ok = false;
+        }
+
+        if (!ok) {
+            scene.Clear();
+            return fail(error, QString("malformed scene at line %1").arg(line));
+        }
+    }
+    flush();
+
+    return true;
+}
+
+// ==================================================================================================
+bool SceneIO::SaveText(const QString& path, const Scene& scene, QString* error) {
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate | QFile::Text))
+        return fail(error, file.errorString());
+
+    QTextStream out(&file);
+    out.setRealNumberPrecision(9);  // enough digits for every float to read back exactly
+    out << "pslscene " << VERSION << "\n";
+
+    auto coords = scene.Vertices();
+    auto offsets = scene.Contours();
+    for (size_t i = 0; i < scene.Size(); i++) {
+        auto& polygon = scene.At(i);
+        auto color = polygon.color.alpha() < 255 ? polygon.color.name(QColor::HexArgb) : polygon.color.name();
+        out << "polygon " << color << " " << polygon.extrusion;
+        if (!polygon.transform.isIdentity()) {
+            auto m = polygon.transform.constData();
+            for (int k = 0; k < 16; k++)
+                out << " " << m[k];
+        }
+        out << "\n";
+
+        for (size_t c = polygon.firstContour; c < polygon.firstContour + polygon.contourCount; c++) {
+            out << "contour";
+            for (auto v = offsets[c]; v < offsets[c + 1]; v++)
+                out << " " << coords[2*v] << " " << coords[2*v+1];
+            out << "\n";
+        }
+    }
+
+    out.flush();
+    return out.status() == QTextStream::Ok ? true : fail(error, file.errorString());
+}
+
+// ==================================================================================================
+// PRIVATE MEMBERS
+// ==================================================================================================
+bool SceneIO::isBinary(const QString& path) {
+    return path.endsWith(".pslb", Qt::CaseInsensitive);
+}
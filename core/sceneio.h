@@ -0,0 +1,61 @@
+#ifndef SCENEIO_H
+#define SCENEIO_H
+
+#include <QString>
+#include "scene.h"
+
+// Scene files.
+//
+// Binary (".pslb"), little endian, every section 16-byte aligned:
+//   SceneFileHeader
+//   float32 x,y pairs                  vertexCount * 8 bytes
+//   uint32 contour offsets             (contourCount + 1) * 4 bytes, first 0, last vertexCount
+//   SceneFilePolygon records           polygonCount * 80 bytes
+// Loading maps the file and the scene reads vertices and contour offsets in place; only the
+// per-polygon records are decoded.
+//
+// Text (anything else), one record per line, for interchange:
+//   pslscene 1
+//   polygon <#rrggbb | #aarrggbb> <extrusion> [16 transform values, column major]
+//   contour x0 y0 x1 y1 ...            (first contour of a polygon is the outline, next ones holes)
+class SceneIO
+{
+public:
+    static const uint32_t VERSION = 1;
+
+    struct SceneFileHeader {
+        char magic[4];          // "PSLS"
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t flags;
+        uint64_t vertexCount;
+        uint64_t contourCount;
+        uint64_t polygonCount;
+        uint64_t vertexOffset;  // byte offsets from the start of the file
+        uint64_t contourOffset;
+        uint64_t polygonOffset;
+    };
+
+    struct SceneFilePolygon {
+        uint32_t firstContour;
+        uint32_t contourCount;
+        uint32_t color;         // 0xAARRGGBB
+        float extrusion;
+        float transform[16];    // column major, as QMatrix4x4::constData
+    };
+
+    // picks the format from the extension
+    static bool Load(const QString& path, Scene& scene, QString* error = nullptr);
+    static bool Save(const QString& path, const Scene& scene, QString* error = nullptr);
+
+    static bool LoadBinary(const QString& path, Scene& scene, QString* error = nullptr);
+    static bool SaveBinary(const QString& path, const Scene& scene, QString* error = nullptr);
+
+    static bool LoadText(const QString& path, Scene& scene, QString* error = nullptr);
+    static bool SaveText(const QString& path, const Scene& scene, QString* error = nullptr);
+
+private:
+    static bool isBinary(const QString& path);
+};
+
+#endif // SCENEIO_H
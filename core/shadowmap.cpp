@@ -0,0 +1,135 @@
+#include "shadowmap.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+void ShadowMap::Build(const Mesh& mesh, LightSource::Type type, const QVector3D& vector, int size) {
+    this->size = size;
+    keys.assign(static_cast<size_t>(size) * static_cast<size_t>(size), std::numeric_limits<float>::infinity());
+    if (mesh.points.empty()) { return; }
+
+    // bounding sphere of the scene
+    auto lo = mesh.points[0], hi = lo;
+    for (auto& p : mesh.points) {
+        lo = QVector3D(std::min(lo.x(), p.x()), std::min(lo.y(), p.y()), std::min(lo.z(), p.z()));
+        hi = QVector3D(std::max(hi.x(), p.x()), std::max(hi.y(), p.y()), std::max(hi.z(), p.z()));
+    }
+    auto center = (lo + hi) / 2;
+    auto radius = std::max((hi - lo).length() / 2, 1.0f);
+
+    perspective = type == LightSource::Type::POINT;
+    if (perspective) {
+        // wide enough for the sphere, at most 75 degrees off axis when the light is inside it
+        origin = vector;
+        auto distance = (center - origin).length();
+        forward = distance > 0 ? (center - origin) / distance : QVector3D(0, 0, 1);
+        auto limit = qDegreesToRadians(75.0f);
+        auto halfAngle = distance > radius ? std::min(std::asin(radius / distance), limit) : limit;
+        scale = size / 2.0f / std::tan(halfAngle);
+        nearDepth = std::max(distance - radius, radius * 1e-3f);
+    }
+    else {
+        // the vector points at the light, which shines the other way
+        origin = center;
+        forward = -vector.normalized();
+        scale = size / (2 * radius);
+        nearDepth = -std::numeric_limits<float>::infinity();
+    }
+    auto helper = std::fabs(forward.y()) < 0.9f ? QVector3D(0, 1, 0) : QVector3D(1, 0, 0);
+    right = QVector3D::crossProduct(helper, forward).normalized();
+    up = QVector3D::crossProduct(forward, right);
+    texelDepth = 1 / scale;
+
+    for (auto& face : mesh.faces) {
+        if (face.count < 3) { continue; }
+
+        coords.clear();
+        contours.assign(1, 0);
+        corners.clear();
+        bool behind = false;
+        auto begin = face.first;
+        for (uint32_t l = 0; l < face.loops; l++) {
+            auto end = mesh.loopEnds[face.loop + l];
+            for (auto i = begin; i < end; i++) {
+                auto m = toMap(mesh.points[mesh.indices[i]]);
+                behind = behind || m.z() < nearDepth;
+                corners.push_back(QVector3D(m.x(), m.y(), key(m.z())));
+                coords.push_back(m.x());
+                coords.push_back(m.y());
+            }
+            contours.push_back(static_cast<uint32_t>(coords.size() / 2));
+            begin = end;
+        }
+        if (behind) { continue; }
+
+        // plane of the depth key over the map, through the outline (Newell's normal)
+        double nx = 0, ny = 0, nz = 0;
+        double cx = 0, cy = 0, ck = 0;
+        auto n = contours[1];
+        for (uint32_t k = 0; k < n; k++) {
+            auto& a = corners[k];
+            auto& b = corners[(k + 1) % n];
+            nx += (static_cast<double>(a.y()) - b.y()) * (static_cast<double>(a.z()) + b.z());
+            ny += (static_cast<double>(a.z()) - b.z()) * (static_cast<double>(a.x()) + b.x());
+            nz += (static_cast<double>(a.x()) - b.x()) * (static_cast<double>(a.y()) + b.y());
+            cx += a.x();
+            cy += a.y();
+            ck += a.z();
+        }
+        if (std::fabs(nz) < 1e-9) { continue; }    // edge on to the light
+        auto kx = -nx / nz;
+        auto ky = -ny / nz;
+        auto k0 = ck / n - kx * cx / n - ky * cy / n;
+
+        rasterizer.ForEachSpan(coords.data(), contours.data(), 0, contours.size() - 1, size, size,
+                               [&](int y, int x0, int x1) {
+            auto row = &keys[static_cast<size_t>(y) * static_cast<size_t>(size)];
+            auto k = k0 + kx * (x0 + 0.5) + ky * (y + 0.5);
+            for (int x = x0; x <= x1; x++, k += kx)
+                row[x] = std::min(row[x], static_cast<float>(k));
+        });
+    }
+}
+
+// ==================================================================================================
+bool ShadowMap::IsEmpty() const {
+    return keys.empty();
+}
+
+// ==================================================================================================
+float ShadowMap::Visibility(const QVector3D& p, int radius) const {
+    if (keys.empty()) { return 1; }
+
+    auto m = toMap(p);
+    if (m.z() < nearDepth) { return 1; }
+
+    // a surface seen at 45 degrees moves a texel in depth across a texel
+    auto bias = 2 * texelDepth * (perspective ? m.z() : 1);
+    auto limit = key(m.z() - bias);
+
+    auto cx = static_cast<int>(std::floor(m.x()));
+    auto cy = static_cast<int>(std::floor(m.y()));
+    int lit = 0;
+    for (int y = cy - radius; y <= cy + radius; y++)
+        for (int x = cx - radius; x <= cx + radius; x++)
+            lit += x < 0 || y < 0 || x >= size || y >= size
+                || keys[static_cast<size_t>(y) * static_cast<size_t>(size) + static_cast<size_t>(x)] >= limit;
+    return static_cast<float>(lit) / ((2 * radius + 1) * (2 * radius + 1));
+}
+
+// ==================================================================================================
+// PRIVATE MEMBERS
+// ==================================================================================================
+QVector3D ShadowMap::toMap(const QVector3D& p) const {
+    auto d = p - origin;
+    auto u = QVector3D::dotProduct(d, right);
+    auto v = QVector3D::dotProduct(d, up);
+    auto w = QVector3D::dotProduct(d, forward);
+    auto s = perspective ? scale / w : scale;
+    return QVector3D(size / 2.0f + u * s, size / 2.0f + v * s, w);
+}
@@ -0,0 +1,58 @@
+#ifndef SHADOWMAP_H
+#define SHADOWMAP_H
+
+#include <QVector3D>
+#include <vector>
+#include <cstdint>
+
+#include "mesh.h"
+#include "lightsource.h"
+#include "spanrasterizer.h"
+
+// Depth of the scene seen from one light, for shadow tests. Build runs the scanline rasterizer
+// over the faces in light space with nothing but depth: each face is cut into spans by
+// SpanRasterizer and its depth is a plane over the map, stepped along the span, so there is no
+// color, normal or perspective weight to interpolate. A directional light looks along its
+// direction with an orthographic view of the bounding sphere of the scene; a point light looks
+// at the center of that sphere with a perspective view wide enough to hold it, and faces
+// reaching behind its near plane cast no shadow.
+// The map lives in world space, so it stays valid while only the camera moves.
+class ShadowMap
+{
+private:
+    int size = 0;
+    std::vector<float> keys;    // depth key of every texel, smaller is nearer
+
+    bool perspective = false;
+    QVector3D origin;           // light position, or the center of the scene
+    QVector3D right, up, forward;
+    float scale = 0;            // light space units to texels (at unit depth with perspective)
+    float nearDepth = 0;
+    float texelDepth = 0;       // world size of a texel, at unit depth with perspective
+
+    // scratch of Build
+    std::vector<float> coords;
+    std::vector<uint32_t> contours;
+    std::vector<QVector3D> corners;
+    SpanRasterizer rasterizer;
+
+public:
+    // renders the faces of mesh, whose points must be in world space, from the light
+    void Build(const Mesh& mesh, LightSource::Type type, const QVector3D& vector, int size);
+
+    bool IsEmpty() const;
+
+    // fraction of the light reaching a world position, 0 or 1 from one texel, in between with a
+    // (2 * radius + 1)^2 texel percentage-closer filter; outside the map everything is lit
+    float Visibility(const QVector3D& p, int radius) const;
+
+private:
+    // texel x, y and the depth along the light (not the key) of a world position
+    QVector3D toMap(const QVector3D& p) const;
+
+    inline float key(float depth) const {
+        return perspective ? -1.0f / depth : depth;
+    }
+};
+
+#endif // SHADOWMAP_H
@@ -0,0 +1,130 @@
+#include "spanbuffer.h"
+
+#include <algorithm>
+#include <cmath>
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+void SpanBuffer::Reset(int height, bool perspective) {
+    this->perspective = perspective;
+    rows.resize(static_cast<size_t>(std::max(height, 0)));
+    for (auto& row : rows)
+        row.clear();
+}
+
+// ==================================================================================================
+SpanBuffer::Segment SpanBuffer::Ramp(uint32_t face, int x0, int x1, double xBeg, double xEnd,
+                                     double qBeg, const double* aqBeg, double qEnd, const double* aqEnd) {
+    Segment s;
+    s.x0 = x0;
+    s.x1 = x1;
+    s.face = face;
+
+    auto inv = xEnd > xBeg ? 1.0 / (xEnd - xBeg) : 0.0;
+    auto skip = x0 + 0.5 - xBeg;
+    s.dq = (qEnd - qBeg) * inv;
+    s.q = qBeg + skip * s.dq;
+    for (int k = 0; k < ATTRIBUTES; k++) {
+        s.daq[k] = (aqEnd[k] - aqBeg[k]) * inv;
+        s.aq[k] = aqBeg[k] + skip * s.daq[k];
+    }
+    return s;
+}
+
+// ==================================================================================================
+void SpanBuffer::Insert(int y, const Segment& span) {
+    if (y < 0 || y >= Height() || span.x1 < span.x0) { return; }
+
+    auto& row = rows[static_cast<size_t>(y)];
+    scratch.clear();
+
+    size_t i = 0;
+    while (i < row.size() && row[i].x1 < span.x0)
+        scratch.push_back(row[i++]);
+
+    int x = span.x0;    // first pixel of the span still to place
+    while (x <= span.x1) {
+        if (i == row.size() || row[i].x0 > span.x1) {
+            push(span, x, span.x1);
+            break;
+        }
+
+        auto& old = row[i];
+        if (old.x0 > x) {
+            push(span, x, old.x0 - 1);
+            x = old.x0;
+        }
+        else if (old.x0 < x) {
+            push(old, old.x0, x - 1);
+        }
+
+        auto end = std::min(span.x1, old.x1);
+        resolve(old, span, x, end);
+        if (old.x1 > end)
+            push(old, end + 1, old.x1);
+
+        x = end + 1;
+        i++;
+    }
+
+    while (i < row.size())
+        scratch.push_back(row[i++]);
+    // copied rather than swapped, so every row keeps the capacity it grew to and a frame like
+    // the previous one inserts without allocating
+    row.assign(scratch.begin(), scratch.end());
+}
+
+// ==================================================================================================
+int SpanBuffer::Height() const {
+    return static_cast<int>(rows.size());
+}
+
+// ==================================================================================================
+const std::vector<SpanBuffer::Segment>& SpanBuffer::Row(int y) const {
+    return rows[static_cast<size_t>(y)];
+}
+
+// ==================================================================================================
+// PRIVATE MEMBERS
+// ==================================================================================================
+// appends pixels x0..x1 of s, glued to the previous piece when it is the same face
+void SpanBuffer::push(const Segment& s, int x0, int x1) {
+    if (x1 < x0) { return; }
+
+    if (!scratch.empty()) {
+        auto& last = scratch.back();
+        if (last.face == s.face && last.x1 + 1 == x0) {
+            last.x1 = x1;
+            return;
+        }
+    }
+
+    auto skip = x0 - s.x0;
+    Segment t = s;
+    t.x0 = x0;
+    t.x1 = x1;
+    t.q += skip * s.dq;
+    for (int k = 0; k < ATTRIBUTES; k++)
+        t.aq[k] += skip * s.daq[k];
+    scratch.push_back(t);
+}
+
+// ==================================================================================================
+// pixels x0..x1 covered by both, the winner only changes where the two depth lines cross
+void SpanBuffer::resolve(const Segment& old, const Segment& span, int x0, int x1) {
+    auto d0 = key(span, x0) - key(old, x0);
+    auto d1 = key(span, x1) - key(old, x1);
+    bool spanFirst = d0 < 0;
+    bool spanLast = d1 < 0;
+
+    if (spanFirst == spanLast) {
+        push(spanFirst ? span : old, x0, x1);
+        return;
+    }
+
+    auto cross = x0 + d0 / (d0 - d1) * (x1 - x0);
+    auto split = std::min(std::max(static_cast<int>(floor(cross)), x0), x1 - 1);
+    push(spanFirst ? span : old, x0, split);
+    push(spanLast ? span : old, split + 1, x1);
+}
@@ -0,0 +1,53 @@
+#ifndef SPANBUFFER_H
+#define SPANBUFFER_H
+
+#include <vector>
+#include <cstdint>
+
+// S-buffer: every row holds sorted, non-overlapping segments along which the depth and the
+// attributes are linear. An incoming span is clipped against the segments it overlaps at
+// segment granularity (two lines cross at most once), so occlusion costs O(segments) per row
+// whatever the width of the faces. Nothing reaches the frame until the segments are emitted.
+class SpanBuffer
+{
+public:
+    static const int ATTRIBUTES = 4;    // z, r, g, b
+
+    // attributes are premultiplied by the perspective weight q, as in the AET
+    struct Segment {
+        int x0, x1;         // inclusive
+        uint32_t face;
+        double q, dq;       // at x0 and per pixel
+        double aq[ATTRIBUTES], daq[ATTRIBUTES];
+    };
+
+private:
+    std::vector<std::vector<Segment>> rows;
+    std::vector<Segment> scratch;
+    bool perspective = false;
+
+public:
+    // perspective compares -q (affine over the screen), otherwise the depth
+    void Reset(int height, bool perspective);
+
+    // the span of a face covering pixels x0..x1 of an AET span that runs from xBeg to xEnd,
+    // its attributes start at the center of pixel x0
+    static Segment Ramp(uint32_t face, int x0, int x1, double xBeg, double xEnd,
+                        double qBeg, const double* aqBeg, double qEnd, const double* aqEnd);
+
+    // keeps the nearest of the span and the segments already there, ties keep the segments
+    void Insert(int y, const Segment& span);
+
+    int Height() const;
+    const std::vector<Segment>& Row(int y) const;
+
+private:
+    inline double key(const Segment& s, int x) const {
+        return perspective ? -(s.q + s.dq * (x - s.x0)) : s.aq[0] + s.daq[0] * (x - s.x0);
+    }
+
+    void push(const Segment& s, int x0, int x1);
+    void resolve(const Segment& old, const Segment& span, int x0, int x1);
+};
+
+#endif // SPANBUFFER_H
@@ -0,0 +1,104 @@
+#include "spanrasterizer.h"
+#include "cgutils.h"
+
+#include <algorithm>
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+void SpanRasterizer::Begin(const float* coords, const uint32_t* contours, size_t first, size_t count,
+                           int width, int height) {
+    this->width = width;
+    this->height = height;
+    edges.clear();
+    aet.clear();
+    next = 0;
+    if (width <= 0 || height <= 0) { return; }
+
+    for (auto c = first; c < first + count; c++) {
+        auto begin = contours[c];
+        auto end = contours[c + 1];
+        for (auto i = begin; i < end; i++) {
+            auto j = i + 1 < end ? i + 1 : begin;
+            double ax = coords[2 * i], ay = coords[2 * i + 1];
+            double bx = coords[2 * j], by = coords[2 * j + 1];
+            if (CGUtils::FirstSample(ay) == CGUtils::FirstSample(by)) { continue; }
+            if (ay > by) {
+                std::swap(ax, bx);
+                std::swap(ay, by);
+            }
+
+            Edge e;
+            e.first = CGUtils::FirstSample(ay);
+            e.ymax = CGUtils::FirstSample(by);
+            if (e.ymax <= 0 || e.first >= height) { continue; }
+
+            e.dx = (bx - ax) / (by - ay);
+            e.x = ax + (e.first + 0.5 - ay) * e.dx;
+
+            // rows above the raster are skipped in one step
+            if (e.first < 0) {
+                e.x += e.dx * -e.first;
+                e.first = 0;
+            }
+            edges.push_back(e);
+        }
+    }
+
+    std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.first < b.first; });
+    y = edges.empty() ? height : edges.front().first;
+}
+
+// ==================================================================================================
+const std::vector<SpanRasterizer::Span>* SpanRasterizer::NextRow() {
+    while (y < height && (next < edges.size() || !aet.empty())) {
+        // nothing active, jumps to the next edge
+        if (aet.empty() && edges[next].first > y) {
+            y = edges[next].first;
+            if (y >= height) { break; }
+        }
+
+        auto row = y++;
+        aet.erase(std::remove_if(aet.begin(), aet.end(), [row](const Edge& e) { return e.ymax == row; }),
+                  aet.end());
+        for (; next < edges.size() && edges[next].first == row; next++)
+            aet.push_back(edges[next]);
+
+        // nearly sorted from the previous row
+        for (size_t i = 1; i < aet.size(); i++)
+            for (size_t j = i; j > 0 && aet[j].x < aet[j-1].x; j--)
+                std::swap(aet[j], aet[j-1]);
+
+        runs.clear();
+        for (size_t i = 0; i + 1 < aet.size(); i += 2) {
+            auto x0 = std::max(CGUtils::FirstSample(aet[i].x), 0);
+            auto x1 = std::min(CGUtils::FirstSample(aet[i+1].x), width) - 1;
+            if (x0 > x1) { continue; }
+
+            // spans meeting at a shared edge are one run
+            if (!runs.empty() && runs.back().x1 + 1 >= x0)
+                runs.back().x1 = std::max(runs.back().x1, x1);
+            else
+                runs.push_back({row, x0, x1});
+        }
+
+        for (auto& e : aet)
+            e.x += e.dx;
+
+        if (!runs.empty()) { return &runs; }
+    }
+    return nullptr;
+}
+
+// ==================================================================================================
+size_t SpanRasterizer::Rasterize(const float* coords, const uint32_t* contours, size_t first, size_t count,
+                                 int width, int height, Span* out, size_t capacity) {
+    Begin(coords, contours, first, count, width, height);
+    size_t n = 0;
+    while (auto spans = NextRow()) {
+        if (n < capacity)
+            std::copy_n(spans->begin(), std::min(spans->size(), capacity - n), out + n);
+        n += spans->size();
+    }
+    return n;
+}
@@ -0,0 +1,64 @@
+#ifndef SPANRASTERIZER_H
+#define SPANRASTERIZER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// The scanline fill as a plain polygon rasterizer, for masks rather than display: contours laid
+// out as in Scene (an x,y float array split by an offset table) come out as the run-length spans
+// they cover, row by row, without a frame or depth buffer. Same odd-even rule and pixel-center
+// sampling as the fills (CGUtils::FirstSample), so holes work and two polygons sharing an edge
+// never both cover a pixel of it. The edge tables are reused, rasterizing does not allocate once
+// they have grown to the largest polygon.
+class SpanRasterizer
+{
+public:
+    struct Span {
+        int y;
+        int x0, x1;     // inclusive
+    };
+
+private:
+    struct Edge {
+        int first, ymax;    // rows first..ymax-1
+        double x, dx;
+    };
+
+    std::vector<Edge> edges;    // by first row
+    std::vector<Edge> aet;
+    std::vector<Span> runs;     // of the current row
+    size_t next = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+public:
+    // starts the contours first..first+count, in pixels, clipped to a width x height raster
+    void Begin(const float* coords, const uint32_t* contours, size_t first, size_t count,
+               int width, int height);
+
+    // the spans of the next covered row, left to right, or nullptr past the last one
+    const std::vector<Span>* NextRow();
+
+    // calls f(y, x0, x1) for every span of the contours, returns the number of spans
+    template <class F>
+    size_t ForEachSpan(const float* coords, const uint32_t* contours, size_t first, size_t count,
+                       int width, int height, F f) {
+        Begin(coords, contours, first, count, width, height);
+        size_t n = 0;
+        while (auto spans = NextRow()) {
+            for (auto& s : *spans)
+                f(s.y, s.x0, s.x1);
+            n += spans->size();
+        }
+        return n;
+    }
+
+    // writes the spans to out and returns how many the contours have; past capacity the
+    // rest is only counted, so a second call with a larger buffer gets all of them
+    size_t Rasterize(const float* coords, const uint32_t* contours, size_t first, size_t count,
+                     int width, int height, Span* out, size_t capacity);
+};
+
+#endif // SPANRASTERIZER_H
@@ -0,0 +1,72 @@
+#ifndef SPANSTEPPER_H
+#define SPANSTEPPER_H
+
+#include <algorithm>
+
+// Walks K attributes along a span perspective-correctly without a divide per pixel.
+// a*q and q are linear in screen space; the exact a = (a*q) / q is only computed every
+// SUBDIV pixels, and the attributes are stepped linearly in between. With q = 1 on the
+// whole span (orthographic) the walk is the plain linear interpolation.
+template <int K>
+class SpanStepper
+{
+public:
+    static const int SUBDIV = 16;
+
+    double a[K];        // attributes at the current pixel
+
+private:
+    double aq[K], daq[K];
+    double q, dq;
+    double da[K];
+    int left = 0;       // pixels before the next exact divide
+    int remaining = 0;  // pixels of the span still to walk
+
+public:
+    // aqBeg, qBeg at the start of the span and aqEnd, qEnd dx pixels further, the walk
+    // starts skip pixels into the span and lasts count pixels; both may be fractional
+    void Begin(const double* aqBeg, double qBeg, const double* aqEnd, double qEnd,
+               double dx, double skip, int count) {
+        auto inv = dx > 0 ? 1.0 / dx : 0.0;
+        dq = (qEnd - qBeg) * inv;
+        q = qBeg + skip * dq;
+        for (int k = 0; k < K; k++) {
+            daq[k] = (aqEnd[k] - aqBeg[k]) * inv;
+            aq[k] = aqBeg[k] + skip * daq[k];
+        }
+
+        remaining = count;
+        if (remaining > 0) { segment(); }
+    }
+
+    inline void Next() {
+        if (--remaining <= 0) { return; }
+        if (--left == 0) {
+            segment();
+            return;
+        }
+        for (int k = 0; k < K; k++)
+            a[k] += da[k];
+    }
+
+private:
+    // exact values here and at the end of the segment, never past the end of the span
+    void segment() {
+        left = std::min(SUBDIV, remaining);
+        auto q1 = q + left * dq;
+        auto inv0 = 1.0 / q;
+        auto inv1 = 1.0 / q1;
+        for (int k = 0; k < K; k++) {
+            a[k] = aq[k] * inv0;
+            auto aq1 = aq[k] + left * daq[k];
+            da[k] = (aq1 * inv1 - a[k]) / left;
+            aq[k] = aq1;
+        }
+        q = q1;
+    }
+};
+
+template <int K>
+const int SpanStepper<K>::SUBDIV;
+
+#endif // SPANSTEPPER_H
@@ -0,0 +1,94 @@
+#include "texture.h"
+
+#include <algorithm>
+
+// ==================================================================================================
+static int powerOfTwo(int n) {
+    int p = 1;
+    while (p < n && p < Texture::MAX_SIZE)
+        p <<= 1;
+    return p;
+}
+
+// ==================================================================================================
+static int log2Of(int n) {
+    int bits = 0;
+    while ((1 << bits) < n)
+        bits++;
+    return bits;
+}
+
+// ==================================================================================================
+// PUBLIC MEMBERS
+// ==================================================================================================
+Texture::Texture(const QImage& image) {
+    if (image.isNull()) { return; }
+
+    auto width = powerOfTwo(image.width());
+    auto height = powerOfTwo(image.height());
+    auto level = image.convertToFormat(QImage::Format_ARGB32);
+    if (level.width() != width || level.height() != height)
+        level = level.scaled(width, height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    // each level is the box filter of the previous one
+    size_t offset = 0;
+    for (;;) {
+        MipLevel l;
+        l.width = level.width();
+        l.height = level.height();
+        l.squareBits = log2Of(std::min(l.width, l.height));
+        l.offset = offset;
+        levels.push_back(l);
+
+        offset += static_cast<size_t>(l.width) * static_cast<size_t>(l.height);
+        texels.resize(offset);
+        for (int y = 0; y < l.height; y++) {
+            auto row = reinterpret_cast<const QRgb*>(level.constScanLine(y));
+            for (int x = 0; x < l.width; x++)
+                texels[l.offset + address(l, static_cast<uint32_t>(x), static_cast<uint32_t>(y))] = row[x];
+        }
+
+        if (l.width == 1 && l.height == 1) { break; }
+
+        QImage next(std::max(l.width / 2, 1), std::max(l.height / 2, 1), QImage::Format_ARGB32);
+        for (int y = 0; y < next.height(); y++) {
+            auto y0 = reinterpret_cast<const QRgb*>(level.constScanLine(std::min(2 * y, l.height - 1)));
+            auto y1 = reinterpret_cast<const QRgb*>(level.constScanLine(std::min(2 * y + 1, l.height - 1)));
+            auto out = reinterpret_cast<QRgb*>(next.scanLine(y));
+            for (int x = 0; x < next.width(); x++) {
+                auto x0 = std::min(2 * x, l.width - 1);
+                auto x1 = std::min(2 * x + 1, l.width - 1);
+                QRgb quad[] = {y0[x0], y0[x1], y1[x0], y1[x1]};
+                int a = 0, r = 0, g = 0, b = 0;
+                for (auto c : quad) {
+                    a += qAlpha(c);
+                    r += qRed(c);
+                    g += qGreen(c);
+                    b += qBlue(c);
+                }
+                out[x] = qRgba((r + 2) / 4, (g + 2) / 4, (b + 2) / 4, (a + 2) / 4);
+            }
+        }
+        level = next;
+    }
+}
+
+// ==================================================================================================
+bool Texture::IsNull() const {
+    return levels.empty();
+}
+
+// ==================================================================================================
+int Texture::Levels() const {
+    return static_cast<int>(levels.size());
+}
+
+// ==================================================================================================
+int Texture::Width() const {
+    return levels.empty() ? 0 : levels.front().width;
+}
+
+// ==================================================================================================
+int Texture::Height() const {
+    return levels.empty() ? 0 : levels.front().height;
+}
@@ -0,0 +1,67 @@
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+#include <QImage>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+// Power-of-two texture with its mip chain. Every level is stored in Morton order (the bits of
+// x and y interleaved over the square part, the rest of the longer side on top), so texels
+// close in 2D stay close in memory whatever the direction a rotated face is walked in.
+class Texture
+{
+private:
+    struct MipLevel {
+        int width, height;
+        int squareBits;     // log2(min(width, height))
+        size_t offset;      // of the level in texels
+    };
+
+    std::vector<QRgb> texels;
+    std::vector<MipLevel> levels;
+
+public:
+    // sides are rounded up to powers of two (at most MAX_SIZE) before the chain is built
+    static const int MAX_SIZE = 2048;
+    explicit Texture(const QImage& image);
+
+    bool IsNull() const;
+    int Levels() const;
+    int Width() const;
+    int Height() const;
+
+    // mip level whose texels are about the size of a pixel, footprint in level 0 texels
+    inline int Level(float footprint) const {
+        if (!(footprint > 1)) { return 0; }
+        auto level = static_cast<int>(std::log2(footprint));
+        return level < Levels() ? level : Levels() - 1;
+    }
+
+    // nearest texel of a level, u and v wrap around
+    inline QRgb Sample(int level, float u, float v) const {
+        auto& l = levels[static_cast<size_t>(level)];
+        auto x = static_cast<uint32_t>(static_cast<int>(std::floor(u * l.width))) & static_cast<uint32_t>(l.width - 1);
+        auto y = static_cast<uint32_t>(static_cast<int>(std::floor(v * l.height))) & static_cast<uint32_t>(l.height - 1);
+        return texels[l.offset + address(l, x, y)];
+    }
+
+private:
+    // spreads the low 16 bits of v to the even bits
+    static inline uint32_t spread(uint32_t v) {
+        v &= 0xffff;
+        v = (v | (v << 8)) & 0x00ff00ff;
+        v = (v | (v << 4)) & 0x0f0f0f0f;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    }
+
+    static inline size_t address(const MipLevel& l, uint32_t x, uint32_t y) {
+        auto mask = (1u << l.squareBits) - 1;
+        auto high = (l.width >= l.height ? x : y) >> l.squareBits;
+        return (static_cast<size_t>(high) << (2 * l.squareBits)) | spread(x & mask) | (spread(y & mask) << 1);
+    }
+};
+
+#endif // TEXTURE_H
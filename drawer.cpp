@@ -1,5 +0,0 @@
-#include "drawer.h"
-
-Drawer::Drawer(CanvasOpenGL* canvas) : canvas(canvas) { }
-
-Drawer::~Drawer() {}
@@ -0,0 +1,93 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include "batchrenderer.h"
+#include "sceneio.h"
+#include "modelio.h"
+
+// ==================================================================================================
+// pslrender <scene | mesh> <camera path | frame count> [options]
+// renders the frames to PNG files, headless: only QtCore and QtGui are linked
+int main(int argc, char *argv[]) {
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addPositionalArgument("scene", "Scene file (.pslb or text), or an .obj or .ply mesh.");
+    parser.addPositionalArgument("path", "Camera path file, or a frame count for a turntable.");
+    parser.addOptions({
+        {"output", "Output file pattern, %1 is the frame number.", "pattern", "frame_%1.png"},
+        {"size", "Frame size.", "WxH", "720x480"},
+        {"shading", "flat, gouraud or phong.", "shading", "flat"},
+        {"aa", "Anti-aliased edges."},
+        {"ortho", "Orthographic camera."},
+        {"lod", "Level of detail tolerance in pixels.", "pixels", "0.5"},
+        {"heatmap", "none, tests, writes or shades.", "counter", "none"},
+        {"shadows", "Shadows of the light (gouraud and phong)."},
+        {"pcf", "Shadow filter radius, 0 for hard shadows.", "texels", "1"},
+        {"threads", "Render workers, 0 uses every core.", "n", "0"},
+        {"encoders", "PNG encoder threads, 0 picks a quarter of the workers.", "n", "0"},
+    });
+    parser.process(a);
+
+    auto args = parser.positionalArguments();
+    if (args.size() != 2)
+        parser.showHelp(1);
+
+    BatchRenderer::Settings settings;
+    auto size = parser.value("size").split('x');
+    if (size.size() == 2) {
+        settings.width = std::max(size[0].toInt(), 1);
+        settings.height = std::max(size[1].toInt(), 1);
+    }
+    auto shading = parser.value("shading");
+    settings.shading = shading == "phong" ? PolygonRenderer::Shading::PHONG
+                     : shading == "gouraud" ? PolygonRenderer::Shading::GOURAUD
+                     : PolygonRenderer::Shading::FLAT;
+    settings.antiAliasing = parser.isSet("aa");
+    settings.perspective = !parser.isSet("ortho");
+    settings.lodTolerance = parser.value("lod").toFloat();
+    auto heatmap = parser.value("heatmap");
+    settings.heatmap = heatmap == "tests" ? PolygonRenderer::Heatmap::DEPTH_TESTS
+                     : heatmap == "writes" ? PolygonRenderer::Heatmap::WRITES
+                     : heatmap == "shades" ? PolygonRenderer::Heatmap::SHADING_COST
+                     : PolygonRenderer::Heatmap::NONE;
+    settings.shadows = parser.isSet("shadows");
+    settings.shadowFilter = parser.value("pcf").toInt();
+    settings.output = parser.value("output");
+    settings.threads = parser.value("threads").toInt();
+    settings.encoders = parser.value("encoders").toInt();
+
+    // a mesh is fitted to the frame, a scene is drawn where it was made
+    Scene scene;
+    QString error;
+    if (ModelIO::IsModel(args[0])) {
+        std::unique_ptr<Model> model(new Model);
+        if (!ModelIO::Load(args[0], *model, &error)) {
+            qWarning() << "could not load model" << args[0] << ":" << error;
+            return 1;
+        }
+        model->FitTo(settings.width, settings.height);
+        scene.AddModel(std::move(model));
+    }
+    else if (!SceneIO::Load(args[0], scene, &error)) {
+        qWarning() << "could not load scene" << args[0] << ":" << error;
+        return 1;
+    }
+
+    bool isCount = false;
+    auto frames = args[1].toInt(&isCount);
+    std::vector<BatchRenderer::Key> keys;
+    if (isCount)
+        keys = BatchRenderer::Turntable(frames, settings.width, settings.height);
+    else if (!BatchRenderer::LoadPath(args[1], keys, &error)) {
+        qWarning() << "could not load camera path" << args[1] << ":" << error;
+        return 1;
+    }
+
+    if (!BatchRenderer::Render(scene, keys, settings, &error)) {
+        qWarning() << error;
+        return 1;
+    }
+    return 0;
+}
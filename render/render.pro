@@ -0,0 +1,18 @@
+# pslrender: renders scenes along camera paths to PNG files, no display needed
+
+QT       = core gui
+CONFIG  += console
+CONFIG  -= app_bundle
+
+TARGET = pslrender
+TEMPLATE = app
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../core/core.pri)
+
+SOURCES += \
+    main.cpp
+
+unix:!android: target.path = /opt/PolygonScanLine/bin
+!isEmpty(target.path): INSTALLS += target
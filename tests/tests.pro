@@ -0,0 +1,16 @@
+# tst_render: the reference scene under every shading mode against data/, `make check` runs it
+
+QT       = core gui testlib
+CONFIG  += console testcase
+CONFIG  -= app_bundle
+
+TARGET = tst_render
+TEMPLATE = app
+
+DEFINES += QT_DEPRECATED_WARNINGS
+DEFINES += PSL_TEST_DATA=\\\"$$PWD/data\\\"
+
+include(../core/core.pri)
+
+SOURCES += \
+    tst_render.cpp
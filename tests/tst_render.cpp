@@ -0,0 +1,331 @@
+#include <QtTest>
+#include <QImage>
+#include <QFile>
+#include <QTextStream>
+#include <QtMath>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "polygonrenderer.h"
+#include "framebuffer.h"
+#include "scene.h"
+#include "camera.h"
+#include "lightset.h"
+#include "texture.h"
+
+// Renders the reference scene headless through PolygonRenderer under every shading mode, with
+// and without anti-aliasing, under the SCANLINE and SBUFFER visibility and with a textured
+// outline. Each frame is compared with the image stored in data/ channel by channel, and the median
+// frame time of each mode must stay within a factor of the baseline in data/timings.txt.
+// PSL_UPDATE_REFERENCES=1 rewrites the images and the baseline from the current build instead.
+// Built with CONFIG+=alloctracking, a frame after the first must not allocate at all.
+class RenderTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int WIDTH = 320;
+    static const int HEIGHT = 240;
+    static const int TOLERANCE = 2;         // per channel, rounding differs between compilers
+    static const int MAX_OUTLIERS = 4;      // pixels past the tolerance, edge samples may flip
+    static const int TIMED_FRAMES = 15;
+
+    Scene scene;
+    Camera camera;
+    LightSet lights;
+    Texture texture;
+    std::vector<QPoint> outline;
+    bool update = false;
+
+public:
+    RenderTest();
+
+private slots:
+    void initTestCase();
+    void references_data();
+    void references();
+    void timings_data();
+    void timings();
+    void allocations_data();
+    void allocations();
+
+private:
+    static void modes();
+    static void mode(const char* name, PolygonRenderer::Shading shading, bool antiAliasing,
+                     PolygonRenderer::Visibility visibility = PolygonRenderer::Visibility::ZBUFFER,
+                     bool textured = false);
+    static QImage checker();
+    void setup(PolygonRenderer& renderer);
+    QImage render(qint64* nsecs = nullptr);
+    static QString dataPath(const QString& name);
+    static std::map<QString, qint64> readBaseline();
+    static bool writeBaseline(const std::map<QString, qint64>& baseline);
+};
+
+// ==================================================================================================
+static std::vector<QPointF> regular(double cx, double cy, double outer, double inner, int corners) {
+    std::vector<QPointF> points;
+    int n = inner > 0 ? 2 * corners : corners;
+    for (int i = 0; i < n; i++) {
+        auto radius = inner > 0 && i % 2 == 1 ? inner : outer;
+        auto angle = 2 * M_PI * i / n;
+        points.push_back(QPointF(cx + radius * cos(angle), cy + radius * sin(angle)));
+    }
+    return points;
+}
+
+// ==================================================================================================
+RenderTest::RenderTest() : camera(QVector3D(0, 0, 0), QVector3D(0, 0, 0)), texture(checker()) {}
+
+// ==================================================================================================
+// a concave star, a frame with a hole, a rotated convex hexagon, a translucent pane in front,
+// a slab running off the right side of the frame, a strip with collinear corners, a wedge with
+// its corners off the top left of the frame and the edited outline, textured on some rows
+void RenderTest::initTestCase() {
+    update = qEnvironmentVariableIsSet("PSL_UPDATE_REFERENCES");
+
+    scene.AddPolygon(regular(90, 80, 60, 25, 5), QColor(220, 80, 60), 40);
+    scene.AddPolygon({{QPointF(170, 40), QPointF(290, 40), QPointF(290, 150), QPointF(170, 150)},
+                      {QPointF(200, 70), QPointF(200, 120), QPointF(260, 120), QPointF(260, 70)}},
+                     QColor(60, 160, 220), 30);
+
+    QMatrix4x4 transform;
+    transform.translate(150, 175, 0);
+    transform.rotate(20, 0, 0, 1);
+    scene.AddPolygon(regular(0, 0, 45, 0, 6), QColor(90, 200, 90), 30, transform);
+
+    QMatrix4x4 front;
+    front.translate(0, 0, -70);
+    scene.AddPolygon({QPointF(60, 120), QPointF(250, 120), QPointF(250, 200), QPointF(60, 200)},
+                     QColor(250, 220, 60, 140), 10, front);
+    scene.AddPolygon({QPointF(220, 196), QPointF(420, 176), QPointF(430, 236), QPointF(230, 238)},
+                     QColor(150, 90, 200), 20);
+    scene.AddPolygon({QPointF(255, 152), QPointF(275, 152), QPointF(295, 152), QPointF(295, 162),
+                      QPointF(295, 172), QPointF(255, 172), QPointF(255, 162)},
+                     QColor(230, 130, 40), 15);
+    scene.AddPolygon({QPointF(-80, -60), QPointF(70, -40), QPointF(-40, 70)},
+                     QColor(120, 120, 230), 25);
+    outline = {QPoint(20, 200), QPoint(60, 200), QPoint(60, 235), QPoint(20, 235)};
+
+    auto rotation = QVector3D(20, -25, 0);
+    camera.SetRotation(rotation);
+    lights.Add(LightSource::Type::POINT, QVector3D(WIDTH / 2, HEIGHT / 2, -200));
+    lights.Add(LightSource::Type::DIRECTIONAL, QVector3D(-1, -1, -2), QColor(255, 200, 160), 0.5);
+}
+
+// ==================================================================================================
+void RenderTest::references_data() {
+    modes();
+}
+
+// ==================================================================================================
+void RenderTest::references() {
+    auto name = QString(QTest::currentDataTag());
+    auto path = dataPath(name + ".png");
+    auto image = render().convertToFormat(QImage::Format_ARGB32);
+
+    if (update) {
+        QVERIFY2(image.save(path, "PNG"), qPrintable("could not write " + path));
+        QSKIP("reference image written");
+    }
+
+    QImage reference(path);
+    QVERIFY2(!reference.isNull(), qPrintable("missing reference " + path));
+    reference = reference.convertToFormat(QImage::Format_ARGB32);
+    QCOMPARE(image.size(), reference.size());
+
+    int outliers = 0, worst = 0;
+    for (int y = 0; y < image.height(); y++) {
+        auto a = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+        auto b = reinterpret_cast<const QRgb*>(reference.constScanLine(y));
+        for (int x = 0; x < image.width(); x++) {
+            auto difference = std::max(std::max(abs(qRed(a[x]) - qRed(b[x])), abs(qGreen(a[x]) - qGreen(b[x]))),
+                                       std::max(abs(qBlue(a[x]) - qBlue(b[x])), abs(qAlpha(a[x]) - qAlpha(b[x]))));
+            worst = std::max(worst, difference);
+            if (difference > TOLERANCE) { outliers++; }
+        }
+    }
+
+    if (outliers > MAX_OUTLIERS) {
+        auto actual = name + ".actual.png";
+        image.save(actual, "PNG");
+        QFAIL(qPrintable(QString("%1 pixels differ from %2 by up to %3, the frame is in %4")
+                         .arg(outliers).arg(path).arg(worst).arg(actual)));
+    }
+}
+
+// ==================================================================================================
+void RenderTest::timings_data() {
+    modes();
+}
+
+// ==================================================================================================
+void RenderTest::timings() {
+#ifndef QT_NO_DEBUG
+    QSKIP("timings are only gated in release builds");
+#endif
+    auto name = QString(QTest::currentDataTag());
+
+    // the first frame builds the level of detail and grows the buffers
+    render();
+    std::vector<qint64> frames;
+    for (int i = 0; i < TIMED_FRAMES; i++) {
+        qint64 nsecs;
+        render(&nsecs);
+        frames.push_back(nsecs);
+    }
+    std::nth_element(frames.begin(), frames.begin() + TIMED_FRAMES / 2, frames.end());
+    auto median = frames[TIMED_FRAMES / 2];
+
+    auto baseline = readBaseline();
+    if (update) {
+        baseline[name] = median;
+        QVERIFY2(writeBaseline(baseline), "could not write the timing baseline");
+        QSKIP("timing baseline written");
+    }
+
+    auto it = baseline.find(name);
+    if (it == baseline.end())
+        QSKIP("no timing baseline, record one with PSL_UPDATE_REFERENCES=1");
+
+    // machines differ, only a clear regression fails
+    bool set;
+    auto factor = qEnvironmentVariable("PSL_TIMING_TOLERANCE").toDouble(&set);
+    if (!set || factor <= 0) { factor = 2; }
+    QVERIFY2(median <= it->second * factor,
+             qPrintable(QString("median frame %1 us, baseline %2 us").arg(median / 1000).arg(it->second / 1000)));
+}
+
+// ==================================================================================================
+void RenderTest::allocations_data() {
+    modes();
+}
+
+// ==================================================================================================
+// the mesh, the edge tables and the scratch of the fills are kept by the renderer, once the
+// first frame sized them the same frame again allocates nothing in any stage
+void RenderTest::allocations() {
+#ifndef PSL_ALLOC_TRACKING
+    QSKIP("needs a build with CONFIG+=alloctracking");
+#else
+    PolygonRenderer renderer(&lights, &camera);
+    setup(renderer);
+
+    FrameBuffer frame(WIDTH, HEIGHT);
+    renderer.Render(frame, QColor(255, 255, 255));
+    renderer.Render(frame, QColor(255, 255, 255));
+
+    auto& stats = renderer.Stats();
+    QCOMPARE(stats.stageAllocations[AllocTracker::GEOMETRY], size_t(0));
+    QCOMPARE(stats.stageAllocations[AllocTracker::EDGE_TABLE], size_t(0));
+    QCOMPARE(stats.stageAllocations[AllocTracker::FILL], size_t(0));
+    QCOMPARE(stats.allocations, size_t(0));
+#endif
+}
+
+// ==================================================================================================
+// the renderer settings of every row, named after them
+void RenderTest::modes() {
+    QTest::addColumn<int>("shading");
+    QTest::addColumn<bool>("antiAliasing");
+    QTest::addColumn<int>("visibility");
+    QTest::addColumn<bool>("textured");
+    for (auto antiAliasing : {false, true}) {
+        auto suffix = antiAliasing ? "_aa" : "";
+        mode(qPrintable(QString("flat") + suffix), PolygonRenderer::Shading::FLAT, antiAliasing);
+        mode(qPrintable(QString("gouraud") + suffix), PolygonRenderer::Shading::GOURAUD, antiAliasing);
+        mode(qPrintable(QString("phong") + suffix), PolygonRenderer::Shading::PHONG, antiAliasing);
+        mode(qPrintable(QString("texture") + suffix), PolygonRenderer::Shading::FLAT, antiAliasing,
+             PolygonRenderer::Visibility::ZBUFFER, true);
+    }
+    mode("flat_scanline", PolygonRenderer::Shading::FLAT, false, PolygonRenderer::Visibility::SCANLINE);
+    mode("flat_sbuffer", PolygonRenderer::Shading::FLAT, false, PolygonRenderer::Visibility::SBUFFER);
+    mode("gouraud_sbuffer", PolygonRenderer::Shading::GOURAUD, false, PolygonRenderer::Visibility::SBUFFER);
+    mode("texture_sbuffer", PolygonRenderer::Shading::FLAT, false, PolygonRenderer::Visibility::SBUFFER, true);
+}
+
+// ==================================================================================================
+void RenderTest::mode(const char* name, PolygonRenderer::Shading shading, bool antiAliasing,
+                      PolygonRenderer::Visibility visibility, bool textured) {
+    QTest::newRow(name) << static_cast<int>(shading) << antiAliasing << static_cast<int>(visibility) << textured;
+}
+
+// ==================================================================================================
+// 8x8 two color checker, its mip chain goes down to a single texel
+QImage RenderTest::checker() {
+    QImage image(8, 8, QImage::Format_ARGB32);
+    for (int y = 0; y < image.height(); y++) {
+        auto row = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < image.width(); x++)
+            row[x] = (x + y) % 2 == 0 ? qRgb(32, 64, 192) : qRgb(255, 255, 255);
+    }
+    return image;
+}
+
+// ==================================================================================================
+// the reference scene with the settings of the current row
+void RenderTest::setup(PolygonRenderer& renderer) {
+    QFETCH(int, shading);
+    QFETCH(bool, antiAliasing);
+    QFETCH(int, visibility);
+    QFETCH(bool, textured);
+
+    renderer.SetScene(&scene);
+    renderer.SetShading(static_cast<PolygonRenderer::Shading>(shading));
+    renderer.SetAntiAliasing(antiAliasing);
+    renderer.SetVisibility(static_cast<PolygonRenderer::Visibility>(visibility));
+    if (textured) {
+        renderer.Vertices.clear();
+        for (auto& point : outline)
+            renderer.Vertices.push_back(&point);
+        renderer.SetTexture(&texture);
+    }
+}
+
+// ==================================================================================================
+// one frame of the reference scene, and the time Render took
+QImage RenderTest::render(qint64* nsecs) {
+    PolygonRenderer renderer(&lights, &camera);
+    setup(renderer);
+
+    FrameBuffer frame(WIDTH, HEIGHT);
+    renderer.Render(frame, QColor(255, 255, 255));
+    if (nsecs != nullptr) { *nsecs = renderer.Stats().nsecs; }
+    return frame.Image();
+}
+
+// ==================================================================================================
+QString RenderTest::dataPath(const QString& name) {
+    return QString(PSL_TEST_DATA) + "/" + name;
+}
+
+// ==================================================================================================
+// median nanoseconds per frame of every mode, one "<mode> <nsecs>" line each
+std::map<QString, qint64> RenderTest::readBaseline() {
+    std::map<QString, qint64> baseline;
+    QFile file(dataPath("timings.txt"));
+    if (!file.open(QFile::ReadOnly | QFile::Text)) { return baseline; }
+
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        auto fields = in.readLine().split(' ', QString::SkipEmptyParts);
+        if (fields.size() == 2) { baseline[fields[0]] = fields[1].toLongLong(); }
+    }
+    return baseline;
+}
+
+// ==================================================================================================
+bool RenderTest::writeBaseline(const std::map<QString, qint64>& baseline) {
+    QFile file(dataPath("timings.txt"));
+    if (!file.open(QFile::WriteOnly | QFile::Truncate | QFile::Text)) { return false; }
+
+    QTextStream out(&file);
+    for (auto& entry : baseline)
+        out << entry.first << " " << entry.second << "\n";
+    return true;
+}
+
+QTEST_MAIN(RenderTest)
+
+#include "tst_render.moc"